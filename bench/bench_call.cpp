@@ -0,0 +1,288 @@
+// bench/bench_call.cpp — CALL-heavy workloads against the word table
+//
+// Usage: bench_call
+//
+// "fib" is doubly recursive fib(27) through CALL: one hot word, measuring
+// per-call dispatch overhead. "fanout" registers 65000 named words and runs
+// a driver that CALLs them in a scattered order, so every call touches a
+// different dictionary entry and the entry footprint decides how much of
+// the table stays in cache.
+//
+// "heap", "arena" and "relayout" run the same two-level program: 4096 words
+// that each CALL four private leaves, driven in a scattered order. "heap"
+// keeps every word's bytecode in its own malloc block between unrelated
+// allocations, "arena" copies it into the VM code arena in definition
+// order (all leaves first) and "relayout" additionally runs
+// vm_relayout_words() so each caller sits next to its leaves.
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "v4/internal/vm.h"
+#include "v4/opcodes.hpp"
+#include "v4/vm_api.h"
+
+static const int kRounds = 5;
+static const int kFibN = 27;
+static const int kFanWords = 65000;
+static const int kFanCalls = 65536;
+static const int kFanReps = 25;
+static const int kTreeMids = 4096;
+static const int kTreeLeaves = 4;
+static const int kTreeIncs = 8;
+static const int kTreeReps = 50;
+
+using Clock = std::chrono::steady_clock;
+using Op = v4::Op;
+
+static double ms_since(Clock::time_point t0)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+static void emit8(uint8_t *code, int *k, uint8_t b)
+{
+  code[(*k)++] = b;
+}
+
+static void emit16(uint8_t *code, int *k, uint16_t v)
+{
+  code[(*k)++] = (uint8_t)v;
+  code[(*k)++] = (uint8_t)(v >> 8);
+}
+
+static void emit_op(uint8_t *code, int *k, Op op)
+{
+  emit8(code, k, (uint8_t)op);
+}
+
+/* ( n -- fib(n) ): DUP 2 < IF RET THEN DUP 1- fib SWAP 2 - fib + */
+static int build_fib(uint8_t *code)
+{
+  int k = 0;
+  emit_op(code, &k, Op::DUP);
+  emit_op(code, &k, Op::LIT_U8);
+  emit8(code, &k, 2);
+  emit_op(code, &k, Op::LT);
+  emit_op(code, &k, Op::JZ);
+  emit16(code, &k, 1);
+  emit_op(code, &k, Op::RET);
+  emit_op(code, &k, Op::DUP);
+  emit_op(code, &k, Op::DEC);
+  emit_op(code, &k, Op::CALL);
+  emit16(code, &k, 0);
+  emit_op(code, &k, Op::SWAP);
+  emit_op(code, &k, Op::LIT_U8);
+  emit8(code, &k, 2);
+  emit_op(code, &k, Op::SUB);
+  emit_op(code, &k, Op::CALL);
+  emit16(code, &k, 0);
+  emit_op(code, &k, Op::ADD);
+  emit_op(code, &k, Op::RET);
+  return k;
+}
+
+static double bench_fib(long *calls)
+{
+  uint8_t fib[32];
+  const int len = build_fib(fib);
+  uint8_t main_code[8];
+  int k = 0;
+  emit_op(main_code, &k, Op::LIT_U8);
+  emit8(main_code, &k, kFibN);
+  emit_op(main_code, &k, Op::CALL);
+  emit16(main_code, &k, 0);
+  emit_op(main_code, &k, Op::RET);
+
+  VmConfig cfg{};
+  Vm *vm = vm_create(&cfg);
+  if (!vm || vm_register_word(vm, "fib", fib, len) != 0)
+    return -1.0;
+
+  const Clock::time_point t0 = Clock::now();
+  const v4_err e = vm_exec_raw(vm, main_code, k);
+  const double ms = ms_since(t0);
+  const v4_i32 result = vm_ds_peek_public(vm, 0);
+  vm_destroy(vm);
+  if (e != 0 || result != 196418)
+    return -1.0;
+
+  long c0 = 1, c1 = 1;  // calls(n) = 1 + calls(n - 1) + calls(n - 2)
+  for (int i = 2; i <= kFibN; i++)
+  {
+    const long c = 1 + c1 + c0;
+    c0 = c1;
+    c1 = c;
+  }
+  *calls = c1;
+  return ms;
+}
+
+static double bench_fanout(long *calls)
+{
+  static uint8_t leaf[] = {(uint8_t)Op::INC, (uint8_t)Op::RET};
+  static uint8_t driver[kFanCalls * 3 + 1];
+
+  VmConfig cfg{};
+  cfg.dict_words = kFanWords + 1;
+  Vm *vm = vm_create(&cfg);
+  if (!vm)
+    return -1.0;
+  char name[24];
+  for (int i = 0; i < kFanWords; i++)
+  {
+    snprintf(name, sizeof(name), "leaf-%05d", i);
+    if (vm_register_word(vm, name, leaf, (int)sizeof(leaf)) != i)
+      return -1.0;
+  }
+
+  // Scattered order over the whole table (odd stride, full period)
+  int k = 0;
+  for (int i = 0; i < kFanCalls; i++)
+  {
+    emit_op(driver, &k, Op::CALL);
+    emit16(driver, &k, (uint16_t)((i * 2654435761u) % kFanWords));
+  }
+  emit_op(driver, &k, Op::RET);
+  if (vm_register_word(vm, "driver", driver, k) != kFanWords)
+    return -1.0;
+
+  vm_ds_push(vm, 0);
+  const Clock::time_point t0 = Clock::now();
+  for (int r = 0; r < kFanReps; r++)
+    if (vm_exec_raw(vm, driver, k) != 0)
+      return -1.0;
+  const double ms = ms_since(t0);
+  const v4_i32 total = vm_ds_peek_public(vm, 0);
+  vm_destroy(vm);
+  if (total != kFanCalls * kFanReps)
+    return -1.0;
+  *calls = (long)kFanCalls * kFanReps;
+  return ms;
+}
+
+enum TreeMode
+{
+  kHeap,
+  kArena,
+  kRelayout
+};
+
+static double bench_tree(TreeMode mode, long *calls)
+{
+  const int leaves = kTreeMids * kTreeLeaves;
+  const int leaf_len = kTreeIncs + 1;
+  const int mid_len = kTreeLeaves * 3 + 1;
+  static uint8_t driver[kTreeMids * 3 + 1];
+  static void *blocks[2 * kTreeMids * (kTreeLeaves + 1)];
+  int nblocks = 0;
+
+  VmConfig cfg{};
+  cfg.dict_words = (v4_u32)(leaves + kTreeMids);
+  if (mode != kHeap)
+    cfg.code_arena_size = (v4_u32)(2 * (leaves * leaf_len + kTreeMids * mid_len));
+  Vm *vm = vm_create(&cfg);
+  if (!vm)
+    return -1.0;
+
+  // Each word's bytecode in its own block, with unrelated allocations between
+  uint32_t seed = 12345;
+  int k;
+  bool ok = true;
+  for (int i = 0; i < leaves + kTreeMids && ok; i++)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    blocks[nblocks++] = malloc(64 + (seed >> 22));
+    uint8_t *code = (uint8_t *)malloc((size_t)(i < leaves ? leaf_len : mid_len));
+    blocks[nblocks++] = code;
+    k = 0;
+    if (i < leaves)
+    {
+      for (int j = 0; j < kTreeIncs; j++)
+        emit_op(code, &k, Op::INC);
+    }
+    else
+    {
+      for (int j = 0; j < kTreeLeaves; j++)
+      {
+        emit_op(code, &k, Op::CALL);
+        emit16(code, &k, (uint16_t)((i - leaves) * kTreeLeaves + j));
+      }
+    }
+    emit_op(code, &k, Op::RET);
+    ok = vm_register_word(vm, nullptr, code, k) == i;
+  }
+  if (ok && mode == kRelayout)
+    ok = vm_relayout_words(vm, nullptr, 0) == 0;
+
+  k = 0;
+  for (int i = 0; i < kTreeMids; i++)
+  {
+    emit_op(driver, &k, Op::CALL);
+    emit16(driver, &k, (uint16_t)(leaves + (i * 2654435761u) % kTreeMids));
+  }
+  emit_op(driver, &k, Op::RET);
+
+  double ms = -1.0;
+  if (ok)
+  {
+    vm_ds_push(vm, 0);
+    const Clock::time_point t0 = Clock::now();
+    for (int r = 0; r < kTreeReps && ok; r++)
+      ok = vm_exec_raw(vm, driver, k) == 0;
+    ms = ms_since(t0);
+    if (!ok || vm_ds_peek_public(vm, 0) != leaves * kTreeIncs * kTreeReps)
+      ms = -1.0;
+  }
+  vm_destroy(vm);
+  for (int i = 0; i < nblocks; i++)
+    free(blocks[i]);
+  *calls = (long)kTreeMids * (kTreeLeaves + 1) * kTreeReps;
+  return ms;
+}
+
+static double bench_heap(long *calls)
+{
+  return bench_tree(kHeap, calls);
+}
+
+static double bench_arena(long *calls)
+{
+  return bench_tree(kArena, calls);
+}
+
+static double bench_relayout(long *calls)
+{
+  return bench_tree(kRelayout, calls);
+}
+
+static void report(const char *name, double (*fn)(long *))
+{
+  double best = 1e30;
+  long calls = 0;
+  for (int i = 0; i < kRounds; i++)
+  {
+    const double ms = fn(&calls);
+    if (ms < 0)
+    {
+      printf("%-8s failed\n", name);
+      return;
+    }
+    if (ms < best)
+      best = ms;
+  }
+  printf("%-8s %9.3f ms  %6.2f ns/call  (%ld calls)\n", name, best, best * 1e6 / calls,
+         calls);
+}
+
+int main()
+{
+  printf("best of %d\n", kRounds);
+  report("fib", bench_fib);
+  report("fanout", bench_fanout);
+  report("heap", bench_heap);
+  report("arena", bench_arena);
+  report("relayout", bench_relayout);
+  return 0;
+}
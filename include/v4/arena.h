@@ -20,21 +20,44 @@ extern "C"
    * - No fragmentation
    * - Fast allocation (O(1))
    * - Alignment support
-   * - No individual free (reset only)
+   * - No individual free: LIFO scopes (mark/release) or reset
+   * - Optional chained growth from the host heap
    */
 
+  /** Header of a heap chunk appended by a growable arena (internal). */
+  typedef struct V4ArenaChunk V4ArenaChunk;
+
   /**
    * @brief Arena allocator structure
    *
-   * Manages a fixed buffer for linear memory allocation.
+   * buffer/size/used always describe the block allocations are bumped from:
+   * the caller's buffer, or the newest chunk of a growable arena.
    */
   typedef struct V4Arena
   {
     uint8_t *buffer; /**< Managed buffer base pointer */
     size_t size;     /**< Total buffer size in bytes */
     size_t used;     /**< Currently used bytes */
+
+    V4ArenaChunk *chunk; /**< Newest appended chunk, NULL while in the initial buffer */
+    V4ArenaChunk *spare; /**< Released chunk kept for the next growth */
+    size_t chunk_size;   /**< Minimum chunk payload; 0 = fixed buffer, never grows */
+    size_t spilled;      /**< Bytes used in buffers below the current one */
+    void *free_list;     /**< Blocks the engine freed out of order (V4_NO_MALLOC) */
   } V4Arena;
 
+  /**
+   * @brief Position in an arena, for LIFO scopes
+   *
+   * Obtained from v4_arena_mark(); v4_arena_release() frees everything
+   * allocated after it.
+   */
+  typedef struct V4ArenaMark
+  {
+    V4ArenaChunk *chunk; /**< Chunk current at mark time */
+    size_t used;         /**< Bytes used in that chunk */
+  } V4ArenaMark;
+
   /**
    * @brief Initialize an arena allocator
    *
@@ -44,11 +67,35 @@ extern "C"
    */
   void v4_arena_init(V4Arena *arena, uint8_t *buffer, size_t size);
 
+  /**
+   * @brief Initialize an arena that grows by appending heap chunks
+   *
+   * Allocations are bumped from buffer first (may be NULL with size 0);
+   * when it is full a chunk of at least chunk_size bytes is malloc'ed and
+   * chained on. Call v4_arena_destroy() to return the chunks.
+   *
+   * @param arena      Pointer to arena structure
+   * @param buffer     Optional initial buffer (can be NULL)
+   * @param size       Size of initial buffer in bytes
+   * @param chunk_size Minimum payload of each appended chunk (> 0)
+   */
+  void v4_arena_init_chained(V4Arena *arena, uint8_t *buffer, size_t size,
+                             size_t chunk_size);
+
+  /**
+   * @brief Release every chunk of a growable arena
+   *
+   * The arena is left empty on its initial buffer. No-op for fixed arenas.
+   *
+   * @param arena Pointer to arena
+   */
+  void v4_arena_destroy(V4Arena *arena);
+
   /**
    * @brief Allocate memory from arena with alignment
    *
    * Allocates memory with specified alignment (must be power of 2).
-   * Returns NULL if insufficient space.
+   * Returns NULL if insufficient space and the arena cannot grow.
    *
    * @param arena Pointer to arena
    * @param bytes Number of bytes to allocate
@@ -61,17 +108,39 @@ extern "C"
    * @brief Reset arena to initial state
    *
    * Frees all allocations at once by resetting used counter to 0.
-   * Does not clear memory contents.
+   * Does not clear memory contents. A growable arena returns to its
+   * initial buffer, keeping one chunk for reuse.
    *
    * @param arena Pointer to arena
    */
   void v4_arena_reset(V4Arena *arena);
 
+  /**
+   * @brief Record the current arena position
+   *
+   * @param arena Pointer to arena
+   * @return Mark to pass to v4_arena_release()
+   */
+  V4ArenaMark v4_arena_mark(const V4Arena *arena);
+
+  /**
+   * @brief Free everything allocated since a mark, in O(1)
+   *
+   * Marks must be released in LIFO order; releasing an outer mark also
+   * releases all inner ones. Chunks appended after the mark are returned
+   * (one is kept for reuse). Pointers into the released range, including
+   * VM word names allocated there, become invalid.
+   *
+   * @param arena Pointer to arena
+   * @param mark  Value returned by v4_arena_mark()
+   */
+  void v4_arena_release(V4Arena *arena, V4ArenaMark mark);
+
   /**
    * @brief Get current used bytes
    *
    * @param arena Pointer to arena
-   * @return Number of bytes currently allocated
+   * @return Number of bytes currently allocated (across all chunks)
    */
   size_t v4_arena_used(const V4Arena *arena);
 
@@ -79,10 +148,32 @@ extern "C"
    * @brief Get available bytes
    *
    * @param arena Pointer to arena
-   * @return Number of bytes available for allocation
+   * @return Number of bytes available for allocation without growing
    */
   size_t v4_arena_available(const V4Arena *arena);
 
+#ifndef V4_NO_MALLOC
+  /**
+   * @brief Calling thread's scratch arena
+   *
+   * A growable arena private to the calling thread, created on first use
+   * with V4_ARENA_THREAD_CHUNK-byte chunks. Intended for per-request
+   * scratch memory: mark at request start, release at the end. Not
+   * available in V4_NO_MALLOC builds.
+   *
+   * @return Thread-local arena (never NULL)
+   */
+  V4Arena *v4_arena_thread(void);
+
+  /**
+   * @brief Free the calling thread's scratch arena chunks
+   *
+   * Call before a worker thread exits. The arena can be used again
+   * afterwards.
+   */
+  void v4_arena_thread_destroy(void);
+#endif /* V4_NO_MALLOC */
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,149 @@
+#pragma once
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "v4/arena.h"
+
+/**
+ * Engine-internal storage for VM structures, tables, word names, task
+ * stacks and snapshots.
+ *
+ * Default builds use the C heap and ignore `arena`. V4_NO_MALLOC builds
+ * take every block from `arena` (VmConfig::arena for a VM) and never call
+ * malloc/free. v4_dealloc() of the most recent block lowers the arena's
+ * bump pointer; any other block goes on the arena's free list (address
+ * ordered, neighbours merged) and is reused first-fit by v4_alloc(), so
+ * frees may come in any order. A NULL arena fails every allocation.
+ */
+
+/* Node of V4Arena::free_list, stored in the freed block itself. */
+struct V4FreeBlock
+{
+  V4FreeBlock *next; /* next block at a higher address */
+  size_t size;       /* bytes, a multiple of max_align_t */
+};
+
+#ifdef V4_NO_MALLOC
+
+static_assert(sizeof(V4FreeBlock) <= alignof(max_align_t),
+              "a free-list node must fit in one allocation unit");
+
+/* Blocks are whole max_align_t units, so a block is on top of the arena
+ * exactly when its rounded end is the arena's current end. */
+static inline size_t v4_alloc_round(size_t n)
+{
+  return (n + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+}
+
+static inline void *v4_alloc(V4Arena *arena, size_t n)
+{
+  if (n > v4_alloc_round(n))
+    return nullptr;  // wrapped
+  n = v4_alloc_round(n);
+  if (arena && n > 0)
+  {
+    // First fit; the remainder of a larger block stays in place on the list
+    for (V4FreeBlock **pp = (V4FreeBlock **)&arena->free_list; *pp; pp = &(*pp)->next)
+    {
+      V4FreeBlock *b = *pp;
+      if (b->size < n)
+        continue;
+      if (b->size == n)
+      {
+        *pp = b->next;
+      }
+      else
+      {
+        V4FreeBlock *rest = (V4FreeBlock *)(void *)((uint8_t *)b + n);
+        rest->next = b->next;
+        rest->size = b->size - n;
+        *pp = rest;
+      }
+      return b;
+    }
+  }
+  return v4_arena_alloc(arena, n, alignof(max_align_t));
+}
+
+static inline void v4_dealloc(V4Arena *arena, void *p, size_t n)
+{
+  uint8_t *const q = (uint8_t *)p;
+  n = v4_alloc_round(n);
+  if (!arena || !q || n == 0 || q < arena->buffer || q + n > arena->buffer + arena->used)
+    return;
+
+  V4FreeBlock **pp = (V4FreeBlock **)&arena->free_list;
+  V4FreeBlock **prev_link = nullptr;
+  V4FreeBlock *prev = nullptr;
+  while (*pp && (uint8_t *)*pp < q)
+  {
+    prev_link = pp;
+    prev = *pp;
+    pp = &prev->next;
+  }
+  if (q + n == arena->buffer + arena->used)
+  {
+    // Top block: lower the bump pointer, taking a free block below with it
+    arena->used -= n;
+    if (prev && (uint8_t *)prev + prev->size == q)
+    {
+      arena->used -= prev->size;
+      *prev_link = nullptr;
+    }
+    return;
+  }
+
+  V4FreeBlock *b = (V4FreeBlock *)(void *)q;
+  b->size = n;
+  b->next = *pp;
+  if (b->next && q + n == (uint8_t *)b->next)
+  {
+    b->size += b->next->size;
+    b->next = b->next->next;
+  }
+  if (prev && (uint8_t *)prev + prev->size == q)
+  {
+    prev->size += b->size;
+    prev->next = b->next;
+  }
+  else
+  {
+    *pp = b;
+  }
+}
+
+static inline void *v4_realloc(V4Arena *arena, void *p, size_t old_n, size_t n)
+{
+  void *q = v4_alloc(arena, n);
+  if (q && p)
+  {
+    memcpy(q, p, old_n < n ? old_n : n);
+    v4_dealloc(arena, p, old_n);
+  }
+  return q;
+}
+
+#else
+
+static inline void *v4_alloc(V4Arena *arena, size_t n)
+{
+  (void)arena;
+  return malloc(n);
+}
+
+static inline void v4_dealloc(V4Arena *arena, void *p, size_t n)
+{
+  (void)arena;
+  (void)n;
+  free(p);
+}
+
+static inline void *v4_realloc(V4Arena *arena, void *p, size_t old_n, size_t n)
+{
+  (void)arena;
+  (void)old_n;
+  return realloc(p, n);
+}
+
+#endif  // V4_NO_MALLOC
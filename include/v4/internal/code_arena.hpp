@@ -0,0 +1,28 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "v4/internal/vm.h"
+#include "v4/vm_api.h"
+
+/**
+ * VM-owned code arena (VmConfig::code_arena_size).
+ *
+ * One V4_CODE_LINE-aligned block, taken from the VM's allocator on the first
+ * copy and filled bump-style. Words hold plain pointers into it, so CALL
+ * is unchanged. vm_relayout_words() rewrites the block in place, which is
+ * why it never grows: a running word must not have its bytes moved. For the
+ * same reason it is refused while forks (Vm::fork_count), which run the
+ * template's words in place, are alive.
+ */
+
+/* Copy len bytes of bytecode into the arena. Returns NULL when the arena is
+ * full or cannot be allocated. */
+const uint8_t *v4_code_copy(Vm *vm, const uint8_t *code, int len);
+
+/* Release the arena block (no-op without one). */
+void v4_code_free(Vm *vm);
+
+/* Resize Vm::word_calls, if allocated, to cap entries (new ones zero); cap 0
+ * frees it and stops profiling. False if the counters cannot grow. */
+bool v4_word_calls_resize(Vm *vm, int cap);
@@ -0,0 +1,36 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "v4/internal/vm.h"
+#include "v4/vm_api.h"
+
+/**
+ * Copy-on-write RAM for vm_fork().
+ *
+ * On the first fork the template's RAM image (from the start of its page,
+ * including any masked-mode tail) is copied into an anonymous memory file.
+ * Every fork then maps that file MAP_PRIVATE, so spawning costs one mmap()
+ * and a fork only pays for the pages it writes. The first store to the
+ * template's RAM afterwards (V4_WATCH_COW) closes the file, so the next fork
+ * captures the template as it is then; existing forks keep their mapping.
+ *
+ * Hosts without memfd (V4_HAVE_COW_MAP unset) fall back to a private heap
+ * copy per fork.
+ */
+
+#if defined(__linux__)
+#define V4_HAVE_COW_MAP 1
+#endif
+
+/* Capture tmpl's RAM image (no-op while the captured one is still current). */
+v4_err v4_cow_snapshot(Vm *tmpl);
+
+/* Give child a private copy-on-write view of tmpl's image. Sets child->mem. */
+v4_err v4_cow_map(Vm *child, const Vm *tmpl);
+
+/* Release child's view (no-op if it has none). */
+void v4_cow_unmap(Vm *child);
+
+/* Drop tmpl's captured image (no-op if none). Existing forks keep theirs. */
+void v4_cow_release(Vm *tmpl);
@@ -0,0 +1,37 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "v4/internal/vm.h"
+#include "v4/vm_api.h"
+
+/**
+ * Guard-page backed RAM (V4_MEM_GUARDED).
+ *
+ * The VM reserves its full 32-bit address range plus a guard page with
+ * PROT_NONE and only makes the first mem_size bytes accessible, aligned so
+ * that RAM ends exactly on a page boundary. While bytecode runs under
+ * v4_guard_exec(), LOAD/STORE skip the range check; any out-of-range access
+ * faults inside the reservation and the SIGSEGV handler unwinds back to
+ * v4_guard_exec(), which reports OobMemory like a checked access would.
+ *
+ * The SIGSEGV handler is process-wide and chains to whatever handler it
+ * replaced; v4_guard_alloc() reinstalls it if something else took over.
+ * Only available on 64-bit Linux (V4_HAVE_GUARDED_MEM).
+ */
+
+#if defined(__linux__) && UINTPTR_MAX > 0xFFFFFFFFu && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define V4_HAVE_GUARDED_MEM 1
+#endif
+
+typedef v4_err (*v4_exec_loop_fn)(Vm *vm, const uint8_t *bc, int len);
+
+/* Reserve the address range and map mem_size bytes of RAM. Sets vm->mem. */
+v4_err v4_guard_alloc(Vm *vm, v4_u32 mem_size);
+
+/* Release the reservation (no-op if none). */
+void v4_guard_free(Vm *vm);
+
+/* Run loop(vm, bc, len) with fault recovery armed for vm. */
+v4_err v4_guard_exec(Vm *vm, const uint8_t *bc, int len, v4_exec_loop_fn loop);
@@ -0,0 +1,28 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "v4/internal/vm.h"
+#include "v4/vm_api.h"
+
+/**
+ * File-backed VM RAM (VmConfig::mem_file).
+ *
+ * The file is opened (created if missing), grown to map_len bytes if it is
+ * shorter, and mapped MAP_SHARED. RAM contents therefore survive restarts and
+ * page in lazily on first touch. Only available on POSIX hosts
+ * (V4_HAVE_MEM_FILE).
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+#define V4_HAVE_MEM_FILE 1
+#endif
+
+/* Map `path` as map_len bytes of RAM. Sets vm->mem / vm->mem_map. */
+v4_err v4_mem_file_map(Vm *vm, const char *path, size_t map_len);
+
+/* Flush dirty pages to the file; wait selects MS_SYNC over MS_ASYNC. */
+v4_err v4_mem_file_sync(Vm *vm, bool wait);
+
+/* Unmap (no-op if RAM is not file-backed). Does not sync. */
+void v4_mem_file_unmap(Vm *vm);
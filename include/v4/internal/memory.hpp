@@ -17,6 +17,80 @@ v4_err v4_mem_read16_core(Vm *vm, v4_u32 addr, v4_u32 *out);
 v4_err v4_mem_write8_core(Vm *vm, v4_u32 addr, v4_u32 val);
 v4_err v4_mem_write16_core(Vm *vm, v4_u32 addr, v4_u32 val);
 
+/* How LOAD/STORE reach primary RAM. vm_exec_raw() picks one per run, so the
+ * checked path carries no tests for the other modes:
+ *  - CHECKED: range check, then alignment (default)
+ *  - MASKED:  wrap with vm->mem_mask (V4_MEM_MASKED)
+ *  - GUARDED: no check, faults unwind to v4_guard_exec() (V4_MEM_GUARDED,
+ *             only while a guard frame is armed)
+ * The untemplated accessors above choose CHECKED or MASKED from the VM. */
+enum V4MemPath
+{
+  V4_MEM_PATH_CHECKED,
+  V4_MEM_PATH_MASKED,
+  V4_MEM_PATH_GUARDED
+};
+
+template <V4MemPath P>
+v4_err v4_mem_read32_core(Vm *vm, v4_u32 addr, v4_u32 *out);
+template <V4MemPath P>
+v4_err v4_mem_write32_core(Vm *vm, v4_u32 addr, v4_u32 val);
+template <V4MemPath P>
+v4_err v4_mem_read8_core(Vm *vm, v4_u32 addr, v4_u32 *out);
+template <V4MemPath P>
+v4_err v4_mem_read16_core(Vm *vm, v4_u32 addr, v4_u32 *out);
+template <V4MemPath P>
+v4_err v4_mem_write8_core(Vm *vm, v4_u32 addr, v4_u32 val);
+template <V4MemPath P>
+v4_err v4_mem_write16_core(Vm *vm, v4_u32 addr, v4_u32 val);
+
+/* Atomic 32-bit cell operations on host memory (RAM, regions, direct
+ * windows): ALOAD is acquire, ASTORE release, CAS/AADD sequentially
+ * consistent. CAS and AADD return the previous cell value in *old. */
+v4_err v4_mem_aload32(Vm *vm, v4_u32 addr, v4_u32 *out);
+v4_err v4_mem_astore32(Vm *vm, v4_u32 addr, v4_u32 val);
+v4_err v4_mem_cas32(Vm *vm, v4_u32 addr, v4_u32 expected, v4_u32 desired, v4_u32 *old);
+v4_err v4_mem_aadd32(Vm *vm, v4_u32 addr, v4_u32 n, v4_u32 *old);
+
+/* Cells hold little-endian values; atomics operate on host-order words. */
+static inline v4_u32 v4_le_to_host(v4_u32 v)
+{
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return __builtin_bswap32(v);
+#else
+  return v;
+#endif
+}
+
+/* Checkpoint page size (bytes = 1 << V4_CKPT_PAGE_SHIFT). */
+#ifndef V4_CKPT_PAGE_SHIFT
+#define V4_CKPT_PAGE_SHIFT 8
+#endif
+
+/* Granule of the RAM shadow bitmap used by address decode
+ * (bytes = 1 << V4_DECODE_PAGE_SHIFT). */
+#ifndef V4_DECODE_PAGE_SHIFT
+#define V4_DECODE_PAGE_SHIFT 12
+#endif
+
+/* Save the checkpoint copy of every not-yet-dirty page in [addr, addr + len)
+ * of primary RAM (src/checkpoint.cpp). Only called while tracking is on. */
+void v4_ckpt_touch(Vm *vm, v4_u32 addr, v4_u32 len);
+
+/* Vm::write_watch bits: state that goes stale when primary RAM changes. */
+#define V4_WATCH_CKPT 0x01u /* checkpoint tracking is on (ckpt_bits) */
+#define V4_WATCH_COW 0x02u  /* a fork image of this RAM is held (cow_fd) */
+
+/* Report a store to every watcher in vm->write_watch (src/memory.cpp). */
+void v4_mem_watch_write(Vm *vm, v4_u32 addr, v4_u32 len);
+
+/* Must precede every store into primary RAM (vm->mem). */
+static inline void v4_mem_note_write(Vm *vm, v4_u32 addr, v4_u32 len)
+{
+  if (vm->write_watch)
+    v4_mem_watch_write(vm, addr, len);
+}
+
 /* Alignment check (4-byte). Returns 0 or -12 (Unaligned). */
 static inline v4_err v4_is_aligned4(v4_u32 addr)
 {
@@ -29,3 +103,15 @@ static inline v4_err v4_is_in_ram(Vm *vm, v4_u32 addr, v4_u32 bytes)
   uint64_t b = (uint64_t)addr + (uint64_t)bytes;
   return (vm->mem && b <= (uint64_t)vm->mem_size) ? 0 : -13;
 }
+
+/* Host pointer to a RAM byte range, or NULL if any byte lies outside RAM.
+ * Used by bulk kernels that operate on (addr, len) ranges. */
+static inline uint8_t *v4_ram_range(Vm *vm, v4_u32 addr, v4_u32 len)
+{
+  return v4_is_in_ram(vm, addr, len) == 0 ? vm->mem + addr : nullptr;
+}
+
+/* Host pointer to [addr, addr + len) in an extra region carrying all `need`
+ * attributes (V4_REGION_*), or in primary RAM (always read/write/execute).
+ * NULL if the range is empty, hits MMIO, or is not fully inside one target. */
+uint8_t *v4_mem_host_range(Vm *vm, v4_u32 addr, v4_u32 len, v4_u32 need);
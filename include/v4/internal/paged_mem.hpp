@@ -0,0 +1,30 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "v4/internal/vm.h"
+#include "v4/vm_api.h"
+
+/**
+ * Sparse VM-owned RAM (V4_MEM_PAGED).
+ *
+ * RAM is one private anonymous mapping reserved without swap accounting, so
+ * a large mem_size costs address space only: the host MMU allocates a page
+ * on its first write and untouched pages read as zero. Translation is the
+ * hardware page table, so LOAD/STORE keep the plain checked fast path.
+ * Only available on POSIX hosts (V4_HAVE_PAGED_MEM).
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+#define V4_HAVE_PAGED_MEM 1
+#endif
+
+/* Reserve mem_size bytes of lazily populated RAM. Sets vm->mem / page_map. */
+v4_err v4_paged_alloc(Vm *vm, v4_u32 mem_size);
+
+/* Unmap (no-op if RAM is not paged). */
+void v4_paged_free(Vm *vm);
+
+/* Copy paged RAM into dst, which must already read as zero, skipping pages
+ * the host never populated so a sparse image stays sparse. */
+void v4_paged_copy(const Vm *vm, uint8_t *dst);
@@ -0,0 +1,96 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "v4/internal/memory.hpp"
+#include "v4/internal/vm.h"
+#include "v4/vm_api.h"
+
+/**
+ * Core SYS kernels (IDs V4_SYS_KERNEL_FIRST..V4_SYS_KERNEL_LAST).
+ *
+ * Each kernel is described by its stack signature: the SYS dispatcher pops
+ * n_in arguments (in[0] is the deepest), calls fn, and pushes n_out results
+ * (out[0] first). A non-zero return from fn aborts execution through
+ * vm_panic(), exactly like a failing LOAD/STORE.
+ */
+
+enum
+{
+  V4_SYS_KERNEL_MAX_IN = 4,
+  V4_SYS_KERNEL_MAX_OUT = 3
+};
+
+typedef v4_err (*v4_sys_kernel_fn)(Vm *vm, const v4_i32 *in, v4_i32 *out);
+
+typedef struct V4SysKernel
+{
+  uint16_t id;         /**< SYS ID (see sys_ids.h) */
+  uint8_t n_in;        /**< Number of stack arguments */
+  uint8_t n_out;       /**< Number of stack results */
+  v4_sys_kernel_fn fn; /**< Implementation */
+} V4SysKernel;
+
+/* Look up a core kernel by SYS ID. Returns NULL if the ID is not a kernel. */
+const V4SysKernel *v4_sys_kernel_find(uint16_t sys_id);
+
+/* Resolve an (addr, len) kernel argument pair to a host pointer.
+ * Returns 0 or -13 (OobMemory). An empty range is always valid. */
+static inline v4_err v4_kernel_range(Vm *vm, v4_i32 addr, v4_i32 len, uint8_t **p)
+{
+  if (len == 0)
+  {
+    *p = nullptr;
+    return 0;
+  }
+  *p = v4_ram_range(vm, (v4_u32)addr, (v4_u32)len);
+  return *p ? 0 : -13;
+}
+
+/* ---- Checksum and hash primitives (src/checksum.cpp) ---- */
+
+uint32_t v4_crc32(uint32_t crc, const uint8_t *p, size_t len);
+uint32_t v4_crc32c(uint32_t crc, const uint8_t *p, size_t len);
+uint16_t v4_crc16_ccitt(uint16_t crc, const uint8_t *p, size_t len);
+uint32_t v4_fnv1a32(uint32_t h, const uint8_t *p, size_t len);
+uint32_t v4_xxh32(uint32_t seed, const uint8_t *p, size_t len);
+
+v4_err v4_k_crc32(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_crc32c(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_crc16_ccitt(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_fnv1a32(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_xxh32(Vm *vm, const v4_i32 *in, v4_i32 *out);
+
+/* ---- Byte search, scanning and formatting (src/text.cpp) ---- */
+
+v4_err v4_k_find_byte(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_find_any(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_find_sub(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_skip_ws(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_parse_dec(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_parse_hex(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_fmt_dec(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_fmt_udec(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_fmt_hex(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_fmt_fixed(Vm *vm, const v4_i32 *in, v4_i32 *out);
+#ifndef V4_USE_V4STD
+v4_err v4_k_type(Vm *vm, const v4_i32 *in, v4_i32 *out);
+#endif
+
+/* ---- TLSF heap in VM RAM (src/heap.cpp) ---- */
+
+v4_err v4_k_allocate(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_free(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_resize(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_heap_stats(Vm *vm, const v4_i32 *in, v4_i32 *out);
+
+/* ---- SPSC ring buffers in VM memory (src/ring.cpp) ---- */
+
+v4_err v4_k_ring_init(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_ring_put(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_ring_get(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_ring_put_cell(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_ring_get_cell(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_ring_write(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_ring_read(Vm *vm, const v4_i32 *in, v4_i32 *out);
+v4_err v4_k_ring_count(Vm *vm, const v4_i32 *in, v4_i32 *out);
@@ -25,7 +25,7 @@ extern "C"
   /**
    * @brief Task Control Block (TCB)
    *
-   * Size: 32 bytes (with alignment)
+   * Size: 40 bytes (with alignment)
    * Each task maintains its own execution context.
    */
   typedef struct
@@ -51,6 +51,10 @@ extern "C"
     /* === Statistics & Debug (4 bytes) === */
     uint16_t exec_count; /**< Execution count (for debugging) */
     uint8_t reserved[2]; /**< Reserved for future use */
+
+    /* === Stack Storage (4 bytes) === */
+    uint16_t ds_cap; /**< Elements allocated at ds_base */
+    uint16_t rs_cap; /**< Elements allocated at rs_base */
   } v4_task_t;
 
   /**
@@ -60,7 +64,7 @@ extern "C"
    */
   typedef struct
   {
-    v4_task_t tasks[V4_MAX_TASKS]; /**< Task table (256 bytes) */
+    v4_task_t tasks[V4_MAX_TASKS]; /**< Task table (320 bytes) */
 
     uint8_t current_task;   /**< Currently running task ID */
     uint8_t task_count;     /**< Number of active tasks */
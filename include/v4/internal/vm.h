@@ -1,5 +1,8 @@
 #pragma once
 #include <stdint.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 #include "v4/internal/task.hpp"
 #include "v4/vm_api.h"
@@ -11,14 +14,68 @@ extern "C"
 
   /**
    * @brief Word structure representing a compiled Forth word.
+   *
+   * Only what CALL/EXECUTE touch, so the hot table stays dense; the name
+   * lives in the cold WordName half of the same dictionary segment.
    */
   typedef struct Word
   {
-    char *name;          /**< Word name (dynamically allocated, can be NULL) */
     const uint8_t *code; /**< Bytecode pointer */
     int code_len;        /**< Length of bytecode in bytes */
+    uint32_t name_off;   /**< Byte offset to this entry's WordName (0 = not in a
+                              dictionary) */
   } Word;
 
+  /** Cold half of a dictionary entry, used by lookup and debugging only. */
+  typedef struct WordName
+  {
+    char *name;    /**< Word name (dynamically allocated, can be NULL) */
+    uint32_t hash; /**< FNV-1a of name for the dictionary index (0 if no name) */
+  } WordName;
+
+  /** Dictionary segment of len entries: len Words followed by len WordNames. */
+  static inline size_t v4_dict_seg_bytes(int len)
+  {
+    return (size_t)len * (sizeof(Word) + sizeof(WordName));
+  }
+
+  /** Cold half of dictionary entry w. */
+  static inline WordName *v4_word_name(const Word *w)
+  {
+    return (WordName *)((const char *)w + w->name_off);
+  }
+
+  /** Decode target kinds (VmDecodeRange::kind). */
+  enum
+  {
+    V4_DECODE_MMIO = 0, /**< callback window, index into Vm::mmio */
+    V4_DECODE_HOST = 1  /**< host memory: extra region or direct MMIO window */
+  };
+
+  /**
+   * @brief One entry of the address-decode table.
+   *
+   * Entries are disjoint, sorted by lo, and already resolve overlaps
+   * (MMIO windows before regions, earliest registered first). Host-memory
+   * entries carry their pointer and attributes so accesses need no
+   * indirection.
+   */
+  typedef struct VmDecodeRange
+  {
+    v4_u32 lo;     /**< First address */
+    v4_u32 last;   /**< Last address (inclusive) */
+    uint8_t kind;  /**< V4_DECODE_MMIO or V4_DECODE_HOST */
+    uint8_t flags; /**< V4_REGION_* attributes (V4_DECODE_HOST) */
+    int index;     /**< Owning target: Vm::mmio index, or mmio_count + region index */
+    uint8_t *data; /**< Host byte for lo (V4_DECODE_HOST), NULL otherwise */
+  } VmDecodeRange;
+
+  /** Dictionary overflow segments (Vm::dict_seg); enough to reach INT32_MAX words. */
+  enum
+  {
+    V4_DICT_SEGS = 31
+  };
+
   /**
    * @brief Internal VM structure (not part of the public API).
    *        Visible only for unit tests or tightly coupled components.
@@ -34,25 +91,94 @@ extern "C"
     /* Memory configuration */
     uint8_t *mem;
     v4_u32 mem_size;
+    v4_u32 mem_mask; /**< mem_size - 1 in V4_MEM_MASKED mode, 0 when checked */
+
+    /* V4_MEM_GUARDED: VM-owned reservation and the armed fault frame */
+    void *guard_base;
+    size_t guard_len;
+    void *guard_frame; /**< Non-NULL while bytecode runs with fault recovery */
+
+    /* File-backed RAM (VmConfig::mem_file) */
+    void *mem_map;       /**< MAP_SHARED mapping, NULL if RAM is not file-backed */
+    size_t mem_map_len;  /**< Mapping length (mem_size + any guard tail) */
+    uint8_t mem_sync;    /**< v4_mem_sync policy */
+
+    /* Sparse RAM (V4_MEM_PAGED) */
+    void *page_map;       /**< Anonymous mapping owning mem, NULL if not paged */
+    size_t page_map_len;  /**< Mapping length (mem_size rounded up to pages) */
+
+    /* Copy-on-write forking (vm_fork) */
+    int cow_fd;          /**< Template: captured RAM image, -1 until first fork */
+    size_t cow_lead;     /**< Template: image bytes before mem (guarded page head) */
+    void *cow_map;       /**< Fork: private view owning mem, NULL if none */
+    size_t cow_map_len;  /**< Fork: length of cow_map */
 
-    /* MMIO window table (fixed capacity, linear search) */
-    enum
-    {
-      V4_MAX_MMIO = 16
-    };
-    V4_Mmio mmio[V4_MAX_MMIO];
+    /* Checkpoint / rollback of primary RAM (vm_checkpoint) */
+    uint8_t *ckpt_shadow; /**< Saved pages: slot i holds page ckpt_dirty[i] */
+    uint32_t *ckpt_bits;  /**< Dirty bitmap, NULL while tracking is off */
+    uint32_t *ckpt_dirty; /**< Indices of dirty pages, in first-write order */
+    uint32_t ckpt_count;  /**< Number of entries in ckpt_dirty */
+    uint32_t ckpt_cap;    /**< Slots in ckpt_shadow and ckpt_dirty (one block) */
+    uint8_t ckpt_lost;    /**< A page could not be saved; rollback refuses */
+
+    uint8_t write_watch; /**< V4_WATCH_* bits: RAM stores must be reported */
+
+    /* TLSF heap in RAM (vm_heap_init); state lives in RAM at heap_ctl */
+    v4_u32 heap_ctl;  /**< Control block address */
+    v4_u32 heap_size; /**< Managed bytes from heap_ctl, 0 if no heap */
+
+    /* MMIO windows (heap-grown, registration order) */
+    V4_Mmio *mmio;
     int mmio_count;
+    int mmio_cap;
+
+    /* Extra memory regions (ROM/flash or additional RAM banks) */
+    V4_Region *regions;
+    int region_count;
+
+    /* Address decode: sorted disjoint ranges. Whole RAM pages are tested
+     * against decode_shadow, everything above them against the hull. */
+    VmDecodeRange *decode;
+    int decode_count;
+    int decode_cap;          /**< Entries allocated at decode */
+    v4_u32 decode_lo;        /**< First decoded address above the RAM pages */
+    v4_u32 decode_hull;      /**< Last decoded address - decode_lo */
+    v4_u32 decode_pages;     /**< Whole RAM pages covered by decode_shadow */
+    uint32_t *decode_shadow; /**< Bit per RAM page with a range on it, or NULL */
 
     /* Execution state */
     int last_err; /**< Last error code (0 = OK) */
 
-    /* Word dictionary (for CALL opcode) */
-    enum
-    {
-      V4_MAX_WORDS = 256
-    };
-    Word words[V4_MAX_WORDS]; /**< Word dictionary */
-    int word_count;           /**< Number of registered words */
+    /* Word dictionary (for CALL opcode), allocated on first registration.
+     * Segments never move once allocated, so Word pointers stay valid. */
+    Word *words; /**< Segment 0: entries [0, dict_seg0) */
+    Word *dict_seg[V4_DICT_SEGS]; /**< Segment k at dict_seg[k - 1]: entries
+                                       [dict_seg0 << (k - 1), dict_seg0 << k) */
+    int dict_seg0;  /**< Entries in segment 0, 0 until the first registration */
+    int word_count; /**< Number of registered words */
+    int word_cap;   /**< Allocated entries over all segments */
+    int dict_init;  /**< First allocation in words (VmConfig::dict_words) */
+    int dict_max;   /**< Growth limit in words (VmConfig::dict_max_words) */
+    int dict_base;  /**< Leading words inherited from a fork template
+                         (names borrowed, never freed here) */
+    int32_t *dict_index; /**< Name hash index for vm_find_word(): open-addressed
+                              word indices, -1 = empty slot */
+    int dict_index_cap;  /**< Slots in dict_index (power of two), 0 = not built */
+
+    /* Owned code arena (VmConfig::code_arena_size), allocated on first use */
+    uint8_t *code_mem;    /**< Copied bytecode, V4_CODE_LINE aligned */
+    void *code_block;     /**< Allocation holding code_mem */
+    v4_u32 code_size;     /**< Arena capacity in bytes (0 = keep caller pointers) */
+    v4_u32 code_used;     /**< Bytes handed out from code_mem */
+
+    /* Per-word call counts (vm_word_profile, V4_WORD_PROFILE builds only) */
+    v4_u32 *word_calls;   /**< Counts by word index, NULL until profiling starts */
+    int word_calls_cap;   /**< Entries in word_calls, >= word_cap once allocated */
+    uint8_t word_profile; /**< CALL/EXECUTE bump word_calls */
+
+    /* Forking: relayout must not move bytecode that forks still run */
+    struct Vm *fork_parent; /**< Template this VM was forked from, or NULL */
+    int fork_count;         /**< Live forks of this VM */
 
     /* Memory management */
     V4Arena *arena; /**< Optional arena allocator (NULL = use malloc) */
@@ -74,6 +200,56 @@ extern "C"
   /* Not part of the public C API. */
   v4_err vm_exec_raw(Vm *vm, const uint8_t *bc, int len);
 
+  /* Index of the highest set bit; x must be nonzero. */
+  static inline int v4_fls32(uint32_t x)
+  {
+#ifdef _MSC_VER
+    unsigned long r;
+    _BitScanReverse(&r, x);
+    return (int)r;
+#else
+    return 31 - __builtin_clz(x);
+#endif
+  }
+
+  /* Index of the lowest set bit; x must be nonzero. */
+  static inline int v4_ffs32(uint32_t x)
+  {
+#ifdef _MSC_VER
+    unsigned long r;
+    _BitScanForward(&r, x);
+    return (int)r;
+#else
+    return __builtin_ctz(x);
+#endif
+  }
+
+  /* Entry idx (< word_cap). Past segment 0, the segment follows from the
+   * bit length of idx relative to dict_seg0. Both are nonzero there:
+   * dict_seg0 >= 1 once a word exists, and idx >= dict_seg0. */
+  static inline Word *v4_dict_word(const Vm *vm, int idx)
+  {
+    if (idx < vm->dict_seg0)
+      return &vm->words[idx];
+    const uint32_t i = (uint32_t)idx;
+    const uint32_t s = (uint32_t)vm->dict_seg0;
+    int k = v4_fls32(i) - v4_fls32(s);
+    if ((i >> k) >= s)
+      k++;
+    return &vm->dict_seg[k - 1][i - (s << (k - 1))];
+  }
+
+  /* Add the next dictionary segment, up to dict_max. False when full or out
+   * of memory. */
+  bool v4_dict_grow(Vm *vm);
+
+  /* Release every dictionary segment (names are the caller's business). */
+  void v4_dict_free(Vm *vm);
+
+  /* Drop the vm_find_word() name index (heap-backed tables only; arena
+   * storage belongs to the arena owner). Rebuilt on next use. */
+  void v4_dict_index_free(Vm *vm);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -23,6 +23,7 @@ enum class PrimKind : uint8_t
   Imm32,  // LIT imm32
   Rel16,  // JMP/JZ/JNZ off16 (signed, byte offset, next-PC based)
   Idx16,  // CALL idx16 (word index)
+  Tbl16,  // JMPTBL count16 default16 rel16[count] (offsets from end of table)
 };
 
 // -----------------------------------------------------------------------------
@@ -44,6 +45,7 @@ struct PrimitiveEntry
 #define PRIM_KIND_IMM32 PrimKind::Imm32
 #define PRIM_KIND_REL16 PrimKind::Rel16
 #define PRIM_KIND_IDX16 PrimKind::Idx16
+#define PRIM_KIND_TBL16 PrimKind::Tbl16
 
 // -----------------------------------------------------------------------------
 // Tier-0 primitive table (auto-generated from opcodes.def)
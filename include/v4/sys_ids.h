@@ -31,3 +31,51 @@
 /* System operations (0xF0 - 0xFF) */
 #define V4_SYS_SYSTEM_RESET 0xFE /**< Perform system reset */
 #define V4_SYS_SYSTEM_INFO 0xFF  /**< Get system info string */
+
+/*
+ * Core kernels (0x0100 - 0x01FF)
+ *
+ * Native primitives over VM memory ranges. They are served by the VM core
+ * in every build (including V4-std builds) because they need direct access
+ * to VM RAM.
+ */
+#define V4_SYS_KERNEL_FIRST 0x0100 /**< First core kernel ID */
+#define V4_SYS_KERNEL_LAST 0x01FF  /**< Last core kernel ID */
+
+/* Checksum and hash kernels (0x0100 - 0x010F) */
+#define V4_SYS_CRC32 0x0100       /**< CRC-32 (IEEE 802.3) of a range */
+#define V4_SYS_CRC32C 0x0101      /**< CRC-32C (Castagnoli) of a range */
+#define V4_SYS_CRC16_CCITT 0x0102 /**< CRC-16/CCITT-FALSE of a range */
+#define V4_SYS_FNV1A32 0x0103     /**< FNV-1a 32-bit hash of a range */
+#define V4_SYS_XXH32 0x0104       /**< xxHash32 of a range */
+
+/* Byte search and scanning kernels (0x0110 - 0x011F) */
+#define V4_SYS_FIND_BYTE 0x0110 /**< Offset of first occurrence of a byte */
+#define V4_SYS_FIND_ANY 0x0111  /**< Offset of first byte from a set */
+#define V4_SYS_FIND_SUB 0x0112  /**< Offset of first occurrence of a substring */
+#define V4_SYS_SKIP_WS 0x0113   /**< Offset of first non-whitespace byte */
+#define V4_SYS_PARSE_DEC 0x0114 /**< Parse signed decimal number */
+#define V4_SYS_PARSE_HEX 0x0115 /**< Parse hexadecimal number */
+
+/* Number formatting and buffered output kernels (0x0120 - 0x012F) */
+#define V4_SYS_FMT_DEC 0x0120   /**< Format signed decimal into a buffer */
+#define V4_SYS_FMT_UDEC 0x0121  /**< Format unsigned decimal into a buffer */
+#define V4_SYS_FMT_HEX 0x0122   /**< Format zero-padded hex into a buffer */
+#define V4_SYS_FMT_FIXED 0x0123 /**< Format decimal fixed-point into a buffer */
+#define V4_SYS_TYPE 0x0124      /**< Write a buffer to the console in one call */
+
+/* RAM heap kernels (0x0130 - 0x013F) */
+#define V4_SYS_ALLOCATE 0x0130   /**< Allocate a heap block */
+#define V4_SYS_FREE 0x0131       /**< Return a heap block */
+#define V4_SYS_RESIZE 0x0132     /**< Grow or shrink a heap block */
+#define V4_SYS_HEAP_STATS 0x0133 /**< Free bytes, largest block, fragmentation */
+
+/* SPSC ring buffer kernels (0x0140 - 0x014F) */
+#define V4_SYS_RING_INIT 0x0140     /**< Format a ring at an address */
+#define V4_SYS_RING_PUT 0x0141      /**< Push one byte */
+#define V4_SYS_RING_GET 0x0142      /**< Pop one byte */
+#define V4_SYS_RING_PUT_CELL 0x0143 /**< Push one cell (4 bytes) */
+#define V4_SYS_RING_GET_CELL 0x0144 /**< Pop one cell (4 bytes) */
+#define V4_SYS_RING_WRITE 0x0145    /**< Push as much of a block as fits */
+#define V4_SYS_RING_READ 0x0146     /**< Pop up to a block of bytes */
+#define V4_SYS_RING_COUNT 0x0147    /**< Bytes queued and space left */
@@ -49,6 +49,22 @@ extern "C"
    */
   typedef v4_err (*v4_mmio_write32_fn)(void *user, v4_u32 addr, v4_u32 val);
 
+  /** 8/16-bit MMIO callbacks; same contract as the 32-bit ones. */
+  typedef v4_err (*v4_mmio_read8_fn)(void *user, v4_u32 addr, v4_u8 *out);
+  typedef v4_err (*v4_mmio_read16_fn)(void *user, v4_u32 addr, v4_u16 *out);
+  typedef v4_err (*v4_mmio_write8_fn)(void *user, v4_u32 addr, v4_u8 val);
+  typedef v4_err (*v4_mmio_write16_fn)(void *user, v4_u32 addr, v4_u16 val);
+
+  /**
+   * @brief Burst MMIO callbacks: transfer len bytes starting at addr.
+   *
+   * Called once per vm_mem_read_block() / vm_mem_write_block() whose whole
+   * range falls inside the window, e.g. to drain or fill a FIFO.
+   */
+  typedef v4_err (*v4_mmio_read_block_fn)(void *user, v4_u32 addr, void *dst, v4_u32 len);
+  typedef v4_err (*v4_mmio_write_block_fn)(void *user, v4_u32 addr, const void *src,
+                                           v4_u32 len);
+
   /**
    * @brief Descriptor for a single MMIO window.
    *
@@ -56,6 +72,19 @@ extern "C"
    * Each window may define separate callbacks for read and write.
    * A NULL callback means that operation is prohibited and will return
    * an "out of bounds" error (-13) when accessed.
+   * Windows take precedence over RAM at the same address; where windows
+   * overlap each other, the one registered first wins.
+   *
+   * A window with non-NULL `data` is a direct window: it is backed by the
+   * host buffer [data, data + size) and accessed like RAM (inline, 8/16/32
+   * bits, no callback), gated by V4_REGION_READ / V4_REGION_WRITE in
+   * `flags`. The callbacks are ignored for direct windows.
+   *
+   * LOAD8/LOAD16/STORE8/STORE16 on a callback window use the 8/16-bit
+   * callbacks and fail with -13 when they are NULL, or when a 16-bit access
+   * starts on the window's last byte. Block transfers use the
+   * burst callbacks when present, otherwise they fall back to one 32-bit
+   * call per cell (aligned transfers) or one 8-bit call per byte.
    */
   typedef struct V4_Mmio
   {
@@ -64,12 +93,120 @@ extern "C"
     v4_mmio_read32_fn read32;   /**< Optional read callback (NULL = forbidden) */
     v4_mmio_write32_fn write32; /**< Optional write callback (NULL = forbidden) */
     void *user;                 /**< User data passed to callbacks */
+    uint8_t *data;              /**< Direct window backing buffer (NULL = callbacks) */
+    v4_u32 flags;               /**< V4_REGION_READ/WRITE for direct windows */
+    v4_mmio_read8_fn read8;     /**< Optional 8-bit read (NULL = forbidden) */
+    v4_mmio_read16_fn read16;   /**< Optional 16-bit read (NULL = forbidden) */
+    v4_mmio_write8_fn write8;   /**< Optional 8-bit write (NULL = forbidden) */
+    v4_mmio_write16_fn write16; /**< Optional 16-bit write (NULL = forbidden) */
+    v4_mmio_read_block_fn read_block;   /**< Optional burst read */
+    v4_mmio_write_block_fn write_block; /**< Optional burst write */
   } V4_Mmio;
 
+  /* ------------------------------------------------------------------------- */
+  /* Memory regions                                                            */
+  /* ------------------------------------------------------------------------- */
+
+  /** Region access attributes (V4_Region::flags). */
+#define V4_REGION_READ 0x1u  /**< LOAD* allowed */
+#define V4_REGION_WRITE 0x2u /**< STORE* allowed */
+#define V4_REGION_EXEC 0x4u  /**< Words may execute bytecode in place */
+#define V4_REGION_SHARED 0x8u /**< Shared between VMs: cells are never torn */
+
+  /**
+   * @brief Additional memory region backed directly by host memory.
+   *
+   * Maps [base, base + size) of the VM address space onto `data` without
+   * copying, e.g. constant tables or bytecode kept in flash. Accesses that
+   * lack the required attribute, or that run past the region end, fail
+   * with -13 (OobMemory). `data` must stay valid for the lifetime of the
+   * VM and is only written through when V4_REGION_WRITE is set.
+   *
+   * Regions live outside the primary RAM (VmConfig::mem); where they
+   * overlap RAM they take precedence, and MMIO windows take precedence
+   * over regions. Bulk SYS kernels only operate on primary RAM.
+   *
+   * V4_REGION_SHARED marks a buffer mapped into several VMs of one process
+   * (possibly at different bases). `data` and `base` must be 4-byte aligned;
+   * LOAD/STORE of a cell are then single relaxed atomic accesses, never
+   * torn. Synchronise through the atomic opcodes: ASTORE is a release,
+   * ALOAD an acquire, CAS/AADD/FENCE are sequentially consistent. Plain
+   * stores made before an ASTORE are visible to a VM whose ALOAD observes
+   * the stored value, so bulk data needs no copy.
+   */
+  typedef struct V4_Region
+  {
+    v4_u32 base;         /**< Base address (absolute) */
+    v4_u32 size;         /**< Region size in bytes */
+    const uint8_t *data; /**< Host backing store */
+    v4_u32 flags;        /**< V4_REGION_* attributes */
+  } V4_Region;
+
   /* ------------------------------------------------------------------------- */
   /* VM configuration                                                          */
   /* ------------------------------------------------------------------------- */
 
+  /**
+   * @brief RAM addressing mode (VmConfig::mem_mode).
+   *
+   * - V4_MEM_CHECKED: every access is range-checked; out-of-range
+   *   addresses fail with -13 (OobMemory). Default.
+   * - V4_MEM_MASKED: WebAssembly-style sandbox. mem_size must be a power
+   *   of two (>= 4) and the buffer must provide V4_MEM_GUARD_BYTES of
+   *   writable slack after mem_size. Addresses are wrapped with
+   *   (addr & (mem_size - 1)) instead of checked, so RAM accesses never
+   *   fail with OobMemory and can never leave the buffer. Bulk SYS
+   *   kernels still range-check their (addr, len) arguments.
+   * - V4_MEM_GUARDED: 64-bit Linux only. The VM allocates RAM itself
+   *   (VmConfig::mem must be NULL) inside a PROT_NONE reservation that
+   *   covers the whole 32-bit address space. LOAD/STORE run without range
+   *   checks; an out-of-range access faults and is reported as -13
+   *   (OobMemory) exactly as in V4_MEM_CHECKED mode. vm_create() fails on
+   *   other platforms. Installs a process-wide SIGSEGV handler that chains
+   *   to the previous one for faults outside VM memory.
+   * - V4_MEM_PAGED: POSIX hosts only. The VM allocates RAM itself
+   *   (VmConfig::mem must be NULL) as a sparse mapping of mem_size bytes:
+   *   host memory is committed page by page on first write and untouched
+   *   pages read as zero, so mem_size can approach 4 GiB while the
+   *   footprint follows the working set (see vm_mem_resident()). Accesses
+   *   are checked as in V4_MEM_CHECKED; translation is done by the host
+   *   MMU at no extra cost.
+   *
+   * MMIO windows are decoded on the raw address before masking, so they
+   * keep working in V4_MEM_MASKED mode. Place them at or above mem_size:
+   * any address not claimed by a window wraps into RAM.
+   */
+  typedef enum v4_mem_mode
+  {
+    V4_MEM_CHECKED = 0,
+    V4_MEM_MASKED = 1,
+    V4_MEM_GUARDED = 2,
+    V4_MEM_PAGED = 3,
+  } v4_mem_mode;
+
+  /**
+   * @brief Durability points for file-backed RAM (VmConfig::mem_sync).
+   *
+   * Independent of the policy, the OS writes dirty pages back on its own
+   * schedule and vm_mem_sync() can be called at any time.
+   */
+  typedef enum v4_mem_sync
+  {
+    V4_SYNC_NONE = 0,       /**< Only explicit vm_mem_sync() calls */
+    V4_SYNC_ON_DESTROY = 1, /**< Blocking flush in vm_destroy() */
+    V4_SYNC_AFTER_EXEC = 2, /**< Asynchronous flush after every vm_exec(), blocking
+                                 flush in vm_destroy() */
+  } v4_mem_sync;
+
+  /** Slack required after mem_size in V4_MEM_MASKED mode. */
+#define V4_MEM_GUARD_BYTES 4
+
+  /** Dictionary capacity when VmConfig::dict_words is 0. */
+#define V4_DICT_DEFAULT_WORDS 256
+
+  /** Alignment of the owned code arena and the line size its layout packs to. */
+#define V4_CODE_LINE 64
+
   /**
    * @brief Configuration structure used when creating a VM instance.
    *
@@ -84,7 +221,22 @@ extern "C"
     const V4_Mmio *mmio; /**< Optional static MMIO table (can be NULL) */
     int mmio_count;      /**< Number of MMIO entries in the table */
     V4Arena *arena; /**< Optional arena allocator for word names (can be NULL, uses malloc
-                       if NULL) */
+                       if NULL). Required in V4_NO_MALLOC builds, where it also
+                       holds the Vm, address map tables, task stacks, snapshots
+                       and checkpoint buffers. */
+    v4_mem_mode mem_mode; /**< RAM addressing mode (0 = V4_MEM_CHECKED) */
+    const V4_Region *regions; /**< Optional extra memory regions (can be NULL) */
+    int region_count;         /**< Number of entries in regions */
+    const char *mem_file; /**< Back RAM with this file (MAP_SHARED); mem must be NULL */
+    v4_mem_sync mem_sync; /**< Durability policy for mem_file */
+    v4_u32 heap_base;     /**< RAM address of the ALLOCATE/FREE heap */
+    v4_u32 heap_size;     /**< Heap bytes (0 = no heap) */
+    v4_u32 dict_words;    /**< Dictionary capacity in words (0 = V4_DICT_DEFAULT_WORDS) */
+    v4_u32 dict_max_words; /**< Double the dictionary when full, up to this many
+                                words (0 or <= dict_words = fixed capacity) */
+    v4_u32 code_arena_size; /**< Copy vm_register_word() bytecode into a VM-owned
+                                 code arena of this many bytes (0 = words point at
+                                 the caller's bytecode) */
   } VmConfig;
 
   /* Forward declarations for opaque VM and Word structures. */
@@ -141,6 +293,28 @@ extern "C"
    */
   void vm_destroy(struct Vm *vm);
 
+  /**
+   * @brief Spawn a VM from a warmed-up template.
+   *
+   * The fork gets a copy-on-write view of the template's RAM (MAP_PRIVATE on
+   * Linux, a private copy elsewhere), so it only costs memory for the pages
+   * it writes. Stacks and the address map are copied. Dictionary entries are
+   * inherited read-only: their names and bytecode stay owned by the
+   * template, which must outlive all of its forks. Words registered in the
+   * fork are its own.
+   *
+   * The RAM image is captured on the first fork and reused until the
+   * template's RAM is next written through the VM (stores, kernels,
+   * vm_mem_write*, vm_rollback); the fork after that captures it again, so
+   * every fork starts from the template's current RAM. Writes made directly
+   * through a host pointer to caller-supplied RAM are not tracked. File-backed
+   * RAM is forked privately and never written back by the fork.
+   *
+   * @param tmpl  Template VM (not running).
+   * @return New VM (free with vm_destroy), or NULL on failure.
+   */
+  struct Vm *vm_fork(struct Vm *tmpl);
+
   /**
    * @brief Execute the given word entry in the specified VM.
    * @param vm     VM instance.
@@ -151,15 +325,47 @@ extern "C"
 
   /**
    * @brief Register a new word in the VM's dictionary.
+   *
+   * Dictionary storage is allocated on the first registration with
+   * VmConfig::dict_words entries and doubled up to dict_max_words when it
+   * fills (CALL reaches the first 65536 words; EXECUTE reaches all).
+   * Growth adds segments and never moves existing entries, so Word pointers
+   * from vm_get_word() stay valid until vm_reset_dictionary() or vm_destroy().
+   *
+   * With VmConfig::code_arena_size set, the bytecode is copied into the
+   * VM's code arena and the caller's buffer may be released afterwards.
+   * Copies are packed back to back; one that fits in a V4_CODE_LINE line
+   * never straddles two.
+   *
    * @param vm        VM instance.
    * @param name      Word name (can be NULL for anonymous words).
    * @param code      Pointer to bytecode.
    * @param code_len  Length of bytecode in bytes.
-   * @return Word index on success (>= 0), negative error code on failure.
+   * @return Word index on success (>= 0), -17 (DictionaryFull) at the
+   *         capacity limit or when storage cannot be grown, -23 (NoMemory)
+   *         when the code arena is exhausted, other negative error codes on
+   *         failure.
    */
   int vm_register_word(struct Vm *vm, const char *name, const uint8_t *code,
                        int code_len);
 
+  /**
+   * @brief Register a word whose bytecode already lives in VM memory.
+   *
+   * Execute-in-place: the word runs directly from [addr, addr + code_len)
+   * without copying, even when the VM has a code arena. The range must lie
+   * entirely in primary RAM or in one region with V4_REGION_EXEC.
+   *
+   * @param vm        VM instance.
+   * @param name      Word name (can be NULL for anonymous words).
+   * @param addr      VM address of the bytecode.
+   * @param code_len  Length of bytecode in bytes.
+   * @return Word index on success (>= 0), -13 (OobMemory) if the range is
+   *         not executable VM memory, other negative error codes as for
+   *         vm_register_word().
+   */
+  int vm_register_word_at(struct Vm *vm, const char *name, v4_u32 addr, int code_len);
+
   /**
    * @brief Get a word by index from the VM's dictionary.
    * @param vm    VM instance.
@@ -171,7 +377,8 @@ extern "C"
   /**
    * @brief Get word name.
    * @param word  Word pointer (from vm_get_word).
-   * @return Word name string, or NULL if word is NULL.
+   * @return Word name string, or NULL for anonymous words, a NULL word and
+   *         words that are not dictionary entries.
    */
   const char *vm_word_get_name(const struct Word *word);
 
@@ -193,8 +400,9 @@ extern "C"
    * @brief Find a word by name in the VM's dictionary.
    *
    * Searches the registered words for one matching the specified name.
-   * The search is case-sensitive and uses linear search O(n).
-   * For typical word counts (tens to hundreds), this is sufficiently fast.
+   * The search is case-sensitive and O(1) on average: names are hashed
+   * into an index maintained by vm_register_word() (taken from
+   * VmConfig::arena when one is set). The newest definition wins.
    *
    * @param vm    VM instance (must not be NULL).
    * @param name  Word name to search for (must not be NULL).
@@ -209,6 +417,60 @@ extern "C"
    */
   int vm_find_word(struct Vm *vm, const char *name);
 
+  /**
+   * @brief Start or stop counting calls per word.
+   *
+   * While on, every CALL and EXECUTE bumps the target's counter. Turning
+   * profiling on clears all counters; turning it off keeps them for
+   * vm_word_get_calls() and vm_relayout_words(). Counting is compiled in
+   * only with -DV4_WORD_PROFILE=ON, so default builds keep CALL free of it;
+   * elsewhere record counts in a profiling build and pass them to
+   * vm_relayout_words().
+   *
+   * @param vm      VM instance.
+   * @param enable  Nonzero to record, 0 to stop.
+   * @return 0 on success, -16 (InvalidArg) for a NULL VM or a build without
+   *         V4_WORD_PROFILE, -23 (NoMemory) if the counters cannot be
+   *         allocated.
+   */
+  v4_err vm_word_profile(struct Vm *vm, int enable);
+
+  /**
+   * @brief Recorded call count of a word.
+   * @param vm   VM instance.
+   * @param idx  Word index.
+   * @return Calls counted since profiling was last turned on, or 0 if the
+   *         index is invalid.
+   */
+  v4_u32 vm_word_get_calls(struct Vm *vm, int idx);
+
+  /**
+   * @brief Reorder the code arena so callers sit next to their callees.
+   *
+   * Only bytecode in the VM's own code arena moves; word indices, names
+   * and words running from caller memory or VM memory are unchanged.
+   * Without a profile, words are laid out depth-first along the static
+   * call graph (CALL sites), starting from words nothing else calls, so
+   * each caller is followed by the callees it reaches first. With a
+   * profile, hot words are laid out the same way starting from the hottest,
+   * callees in descending heat, and never-called words are moved to the
+   * end of the arena.
+   *
+   * Must not be called while the VM is executing. Forks run the template's
+   * bytecode in place, so a template with live forks is refused; relayout
+   * it before forking.
+   *
+   * @param vm     VM instance.
+   * @param calls  Per-word call counts (e.g. saved from vm_word_get_calls()),
+   *               or NULL to use the counts recorded by vm_word_profile().
+   *               Counts of all zero mean no profile.
+   * @param count  Entries in calls; words beyond it count as never called.
+   * @return 0 on success, -16 (InvalidArg) for bad arguments or while forks
+   *         of vm exist, -23 (NoMemory) if scratch space is unavailable or
+   *         the new layout does not fit. The arena is unchanged on error.
+   */
+  v4_err vm_relayout_words(struct Vm *vm, const v4_u32 *calls, int count);
+
   /* ------------------------------------------------------------------------- */
   /* MMIO registration and direct memory access                                */
   /* ------------------------------------------------------------------------- */
@@ -216,13 +478,64 @@ extern "C"
   /**
    * @brief Dynamically register additional MMIO windows.
    *        (May be used after creation.)
+   *
+   * There is no fixed window limit. Registration rebuilds a sorted
+   * address-decode table, so lookups cost O(log n). RAM accesses never
+   * consult it unless a window or region lies on the same RAM page
+   * (1 << V4_DECODE_PAGE_SHIFT bytes), wherever the other windows sit.
+   *
    * @param vm     VM instance.
-   * @param list   Pointer to an array of MMIO descriptors.
+   * @param list   Pointer to an array of MMIO descriptors (copied).
    * @param count  Number of elements in the array.
-   * @return 0 on success, negative value on failure.
+   * @return 0 on success, -23 (NoMemory) if the tables cannot grow,
+   *         -16 (InvalidArg) on bad arguments.
    */
   v4_err vm_register_mmio(struct Vm *vm, const V4_Mmio *list, int count);
 
+  /**
+   * @brief Flush file-backed RAM (VmConfig::mem_file) to its file.
+   * @param vm    VM instance.
+   * @param wait  Non-zero: block until the data is on stable storage
+   *              (MS_SYNC). Zero: schedule write-back and return (MS_ASYNC).
+   * @return 0 on success (also when RAM is not file-backed), -24 (IoError)
+   *         if the flush fails.
+   */
+  v4_err vm_mem_sync(struct Vm *vm, int wait);
+
+  /**
+   * @brief Mark the current contents of primary RAM as the rollback point.
+   *
+   * Starts dirty-page tracking on first use (256-byte pages by default,
+   * see V4_CKPT_PAGE_SHIFT). Every later call commits the writes made since
+   * the previous checkpoint. Cost scales with the pages written, not with
+   * RAM size. Extra regions and MMIO are not covered.
+   *
+   * @param vm  VM instance.
+   * @return 0 on success, -16 (InvalidArg) without RAM, -23 (NoMemory) if
+   *         tracking cannot be set up.
+   */
+  v4_err vm_checkpoint(struct Vm *vm);
+
+  /**
+   * @brief Restore primary RAM to the last checkpoint.
+   *
+   * Copies back only the pages written since vm_checkpoint(); tracking stays
+   * on with the same rollback point. Pages are saved into a pool that grows
+   * on demand; if it could not grow, the rollback point is lost until the
+   * next vm_checkpoint().
+   *
+   * @param vm  VM instance.
+   * @return 0 on success, -16 (InvalidArg) if no checkpoint is active,
+   *         -23 (NoMemory) if a written page could not be saved.
+   */
+  v4_err vm_rollback(struct Vm *vm);
+
+  /**
+   * @brief Stop dirty-page tracking and free the checkpoint (NULL-safe).
+   * @param vm  VM instance.
+   */
+  void vm_checkpoint_end(struct Vm *vm);
+
   /**
    * @brief Read a 32-bit little-endian value from the VM memory space.
    *
@@ -249,6 +562,139 @@ extern "C"
    */
   v4_err vm_mem_write32(struct Vm *vm, v4_u32 addr, v4_u32 val);
 
+  /**
+   * @brief Copy len bytes out of VM memory into a host buffer.
+   *
+   * The whole range is checked once and copied with memcpy. It must lie
+   * entirely in RAM, in one readable region, or in one MMIO window (see
+   * V4_Mmio for how callback windows are driven). No alignment requirement.
+   *
+   * @param vm    VM instance.
+   * @param addr  First VM address.
+   * @param dst   Host destination (may be NULL if len is 0).
+   * @param len   Number of bytes.
+   * @return 0 on success, -13 (OobMemory) if the range is not readable,
+   *         -16 (InvalidArg) on NULL arguments, or a callback's error.
+   */
+  v4_err vm_mem_read_block(struct Vm *vm, v4_u32 addr, void *dst, v4_u32 len);
+
+  /**
+   * @brief Copy len bytes from a host buffer into VM memory.
+   *
+   * Same rules as vm_mem_read_block(); region targets need V4_REGION_WRITE.
+   *
+   * @return 0 on success, -13 (OobMemory) if the range is not writable,
+   *         -16 (InvalidArg) on NULL arguments, or a callback's error.
+   */
+  v4_err vm_mem_write_block(struct Vm *vm, v4_u32 addr, const void *src, v4_u32 len);
+
+  /**
+   * @brief Direct host pointer to [addr, addr + len) of VM memory.
+   *
+   * Succeeds only when the range lies entirely in RAM or in one region with
+   * the requested access (never for MMIO), so the host can parse or fill
+   * it in place. The pointer stays valid until the VM is destroyed. A
+   * writable view of RAM counts as a write to every page it covers for
+   * vm_checkpoint(), taken when the view is created.
+   *
+   * @param vm        VM instance.
+   * @param addr      First VM address.
+   * @param len       Span length in bytes (> 0).
+   * @param writable  Non-zero if the host will write through the pointer.
+   * @return Host pointer, or NULL if the range is not plain memory.
+   */
+  uint8_t *vm_mem_view(struct Vm *vm, v4_u32 addr, v4_u32 len, int writable);
+
+  /**
+   * @brief Bytes of RAM currently backed by host memory.
+   *
+   * Counts the host pages of RAM that are resident. For V4_MEM_PAGED this
+   * is the working set; for a caller buffer it is normally mem_size.
+   *
+   * @param vm  VM instance.
+   * @return Resident bytes (mem_size if the host cannot tell), 0 without RAM.
+   */
+  size_t vm_mem_resident(struct Vm *vm);
+
+  /**
+   * @brief Zero [addr, addr + len) of RAM and drop its host pages.
+   *
+   * In V4_MEM_PAGED mode the whole pages inside the range are returned to
+   * the host and read as zero until written again; elsewhere the range is
+   * just cleared. Counts as a write for vm_checkpoint().
+   *
+   * @return 0 on success, -13 (OobMemory) if the range is not in RAM,
+   *         -16 (InvalidArg) if vm is NULL.
+   */
+  v4_err vm_mem_discard(struct Vm *vm, v4_u32 addr, v4_u32 len);
+
+  /* ------------------------------------------------------------------------- */
+  /* RAM heap (ALLOCATE / FREE / RESIZE kernels)                               */
+  /* ------------------------------------------------------------------------- */
+
+  /** Heap occupancy reported by vm_heap_stats(). */
+  typedef struct V4HeapStats
+  {
+    v4_u32 size;          /**< Bytes managed, including metadata */
+    v4_u32 free_bytes;    /**< Sum of free block payloads */
+    v4_u32 largest_free;  /**< Largest single allocation that can succeed */
+    v4_u32 fragmentation; /**< 100 - largest_free * 100 / free_bytes, in percent */
+  } V4HeapStats;
+
+  /**
+   * @brief Format [addr, addr + size) of RAM as a TLSF heap.
+   *
+   * Allocation, free and resize are O(1). All allocator state is stored in
+   * the range itself, so it follows the VM through vm_fork() and
+   * vm_rollback(). Any previous heap is forgotten; size 0 disables the heap.
+   * Called by vm_create() when VmConfig::heap_size is non-zero.
+   *
+   * @return 0 on success, -16 (InvalidArg) if the range is not in RAM or too
+   *         small to hold the control block and one allocation.
+   */
+  v4_err vm_heap_init(struct Vm *vm, v4_u32 addr, v4_u32 size);
+
+  /**
+   * @brief Report heap occupancy. All fields are 0 when no heap is set up.
+   * @return 0 on success, -16 (InvalidArg) on NULL arguments or corrupted
+   *         heap metadata.
+   */
+  v4_err vm_heap_stats(struct Vm *vm, V4HeapStats *out);
+
+  /* ------------------------------------------------------------------------- */
+  /* SPSC ring buffers (RING_* kernels)                                        */
+  /* ------------------------------------------------------------------------- */
+
+  /**
+   * @brief Format a byte ring at addr: a 12-byte header (head, tail, cap)
+   *        followed by cap bytes of storage.
+   *
+   * addr must be 4-byte aligned in RAM or a read/write region; cap must be a
+   * power of two (at most 1 GiB). One producer and one consumer may then use
+   * the ring concurrently without locks: each side only stores its own
+   * index, with release ordering after the data copy. Not safe to call
+   * while either side is active.
+   *
+   * @return 0 on success, -16 (InvalidArg) for a bad cap, -13 (OobMemory) if
+   *         the ring does not fit, -12 (Unaligned) for a misaligned addr.
+   */
+  v4_err vm_ring_init(struct Vm *vm, v4_u32 addr, v4_u32 cap);
+
+  /**
+   * @brief Producer side from host code (e.g. an ISR feeding a task):
+   *        push as many of len bytes as fit.
+   * @return Bytes pushed (0 if full), or a negative error as for
+   *         vm_ring_init() (-16 also for a corrupted header).
+   */
+  v4_i32 vm_ring_write(struct Vm *vm, v4_u32 ring, const void *src, v4_u32 len);
+
+  /**
+   * @brief Consumer side from host code: pop up to len bytes into dst.
+   * @return Bytes popped (0 if empty), or a negative error as for
+   *         vm_ring_write().
+   */
+  v4_i32 vm_ring_read(struct Vm *vm, v4_u32 ring, void *dst, v4_u32 len);
+
   /* ------------------------------------------------------------------------- */
   /* Minimal stack inspector (for testing)                                     */
   /* ------------------------------------------------------------------------- */
@@ -361,8 +807,9 @@ extern "C"
    */
   typedef struct VmStackSnapshot
   {
-    v4_i32 *data; /**< Stack data (dynamically allocated) */
-    int depth;    /**< Stack depth */
+    v4_i32 *data;   /**< Stack data (dynamically allocated) */
+    int depth;      /**< Stack depth */
+    V4Arena *arena; /**< Arena the snapshot was allocated from (NULL = malloc) */
   } VmStackSnapshot;
 
   /**
@@ -1,7 +1,56 @@
 #include "v4/arena.h"
 
+#include <cstdlib>
 #include <cstring>
 
+#include "v4/internal/alloc.hpp"
+
+#ifndef V4_ARENA_THREAD_CHUNK
+#define V4_ARENA_THREAD_CHUNK 4096
+#endif
+
+/* Chunk header; the payload follows it, aligned to max_align_t. The
+ * previous block's state is saved here so popping a chunk is O(1). */
+struct V4ArenaChunk
+{
+  V4ArenaChunk* prev;   // chunk below this one (NULL = initial buffer)
+  uint8_t* prev_buffer; // block state to restore when this chunk is popped
+  size_t prev_size;
+  size_t prev_used;
+  size_t cap;           // payload bytes
+};
+
+static const size_t kChunkHdr =
+    (sizeof(V4ArenaChunk) + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+
+static inline uint8_t* chunk_data(V4ArenaChunk* c)
+{
+  return reinterpret_cast<uint8_t*>(c) + kChunkHdr;
+}
+
+/* Chunks come from the C heap; V4_NO_MALLOC builds never grow. */
+static V4ArenaChunk* chunk_new(size_t cap)
+{
+#ifdef V4_NO_MALLOC
+  (void)cap;
+  return nullptr;
+#else
+  V4ArenaChunk* c = static_cast<V4ArenaChunk*>(malloc(kChunkHdr + cap));
+  if (c)
+    c->cap = cap;
+  return c;
+#endif
+}
+
+static void chunk_delete(V4ArenaChunk* c)
+{
+#ifdef V4_NO_MALLOC
+  (void)c;
+#else
+  free(c);
+#endif
+}
+
 extern "C" void v4_arena_init(V4Arena* arena, uint8_t* buffer, size_t size)
 {
   if (!arena)
@@ -10,24 +59,91 @@ extern "C" void v4_arena_init(V4Arena* arena, uint8_t* buffer, size_t size)
   arena->buffer = buffer;
   arena->size = size;
   arena->used = 0;
+  arena->chunk = nullptr;
+  arena->spare = nullptr;
+  arena->chunk_size = 0;
+  arena->spilled = 0;
+  arena->free_list = nullptr;
+}
+
+extern "C" void v4_arena_init_chained(V4Arena* arena, uint8_t* buffer, size_t size,
+                                      size_t chunk_size)
+{
+  v4_arena_init(arena, buffer, size);
+  if (arena)
+    arena->chunk_size = chunk_size;
+}
+
+/* Drop the newest chunk, keeping it as the spare if there is none yet. */
+static void pop_chunk(V4Arena* arena)
+{
+  V4ArenaChunk* c = arena->chunk;
+  arena->chunk = c->prev;
+  arena->buffer = c->prev_buffer;
+  arena->size = c->prev_size;
+  arena->used = c->prev_used;
+  arena->spilled -= c->prev_used;
+
+  if (!arena->spare)
+    arena->spare = c;
+  else
+    chunk_delete(c);
+}
+
+/* Switch to a chunk with room for `bytes` at `align`. */
+static bool push_chunk(V4Arena* arena, size_t bytes, size_t align)
+{
+  const size_t slack = align > alignof(max_align_t) ? align - 1 : 0;
+  if (bytes > SIZE_MAX - slack - kChunkHdr)
+    return false;
+  const size_t need = bytes + slack;
+
+  V4ArenaChunk* c = arena->spare;
+  if (c && c->cap >= need)
+  {
+    arena->spare = nullptr;
+  }
+  else
+  {
+    const size_t cap = need > arena->chunk_size ? need : arena->chunk_size;
+    c = chunk_new(cap);
+    if (!c)
+      return false;
+  }
+
+  c->prev = arena->chunk;
+  c->prev_buffer = arena->buffer;
+  c->prev_size = arena->size;
+  c->prev_used = arena->used;
+  arena->spilled += arena->used;
+  arena->chunk = c;
+  arena->buffer = chunk_data(c);
+  arena->size = c->cap;
+  arena->used = 0;
+  return true;
 }
 
 extern "C" void* v4_arena_alloc(V4Arena* arena, size_t bytes, size_t align)
 {
-  if (!arena || !arena->buffer || bytes == 0)
+  if (!arena || (!arena->buffer && arena->chunk_size == 0) || bytes == 0)
     return nullptr;
 
   // Alignment must be power of 2
   if (align == 0 || (align & (align - 1)) != 0)
     return nullptr;
 
-  // Calculate aligned start position
-  size_t current = arena->used;
-  size_t aligned = (current + align - 1) & ~(align - 1);
+  // Calculate aligned start position (absolute, so chunks align too)
+  uintptr_t base = reinterpret_cast<uintptr_t>(arena->buffer);
+  size_t aligned = ((base + arena->used + align - 1) & ~(uintptr_t)(align - 1)) - base;
 
-  // Check if we have enough space
-  if (aligned + bytes > arena->size)
-    return nullptr;
+  // Check if we have enough space, growing if allowed
+  if (!arena->buffer || aligned > arena->size || bytes > arena->size - aligned)
+  {
+    if (arena->chunk_size == 0 || !push_chunk(arena, bytes, align))
+      return nullptr;
+    base = reinterpret_cast<uintptr_t>(arena->buffer);
+    aligned = ((base + align - 1) & ~(uintptr_t)(align - 1)) - base;
+  }
 
   // Allocate
   void* ptr = arena->buffer + aligned;
@@ -36,12 +152,71 @@ extern "C" void* v4_arena_alloc(V4Arena* arena, size_t bytes, size_t align)
   return ptr;
 }
 
+extern "C" V4ArenaMark v4_arena_mark(const V4Arena* arena)
+{
+  V4ArenaMark m = {nullptr, 0};
+  if (arena)
+  {
+    m.chunk = arena->chunk;
+    m.used = arena->used;
+  }
+  return m;
+}
+
+extern "C" void v4_arena_release(V4Arena* arena, V4ArenaMark mark)
+{
+  if (!arena)
+    return;
+
+  // Everything appended after the mark goes; a stale mark empties the arena
+  while (arena->chunk && arena->chunk != mark.chunk)
+    pop_chunk(arena);
+  if (arena->chunk != mark.chunk)
+    arena->used = 0;
+  else if (mark.used < arena->used)
+    arena->used = mark.used;
+
+  // Free-list blocks past the new end are gone with the space they were in;
+  // one that now ends at the top goes back to the bump pointer.
+  V4FreeBlock** link = reinterpret_cast<V4FreeBlock**>(&arena->free_list);
+  while (*link)
+  {
+    uint8_t* p = reinterpret_cast<uint8_t*>(*link);
+    if (p < arena->buffer || p + (*link)->size > arena->buffer + arena->used)
+    {
+      *link = (*link)->next;
+    }
+    else if (p + (*link)->size == arena->buffer + arena->used)
+    {
+      arena->used = static_cast<size_t>(p - arena->buffer);
+      *link = nullptr;
+    }
+    else
+    {
+      link = &(*link)->next;
+    }
+  }
+}
+
 extern "C" void v4_arena_reset(V4Arena* arena)
 {
   if (!arena)
     return;
 
+  while (arena->chunk)
+    pop_chunk(arena);
   arena->used = 0;
+  arena->free_list = nullptr;
+}
+
+extern "C" void v4_arena_destroy(V4Arena* arena)
+{
+  if (!arena)
+    return;
+
+  v4_arena_reset(arena);
+  chunk_delete(arena->spare);
+  arena->spare = nullptr;
 }
 
 extern "C" size_t v4_arena_used(const V4Arena* arena)
@@ -49,7 +224,7 @@ extern "C" size_t v4_arena_used(const V4Arena* arena)
   if (!arena)
     return 0;
 
-  return arena->used;
+  return arena->spilled + arena->used;
 }
 
 extern "C" size_t v4_arena_available(const V4Arena* arena)
@@ -59,3 +234,22 @@ extern "C" size_t v4_arena_available(const V4Arena* arena)
 
   return arena->size - arena->used;
 }
+
+/* Per-thread scratch arenas: heap chunks only, freed by the owning thread.
+ * Not built under V4_NO_MALLOC, where chunks cannot come from the heap and
+ * bare-metal targets may lack TLS. */
+#ifndef V4_NO_MALLOC
+static thread_local V4Arena t_arena = {nullptr, 0, 0, nullptr, nullptr, 0, 0, nullptr};
+
+extern "C" V4Arena* v4_arena_thread(void)
+{
+  if (t_arena.chunk_size == 0)
+    v4_arena_init_chained(&t_arena, nullptr, 0, V4_ARENA_THREAD_CHUNK);
+  return &t_arena;
+}
+
+extern "C" void v4_arena_thread_destroy(void)
+{
+  v4_arena_destroy(&t_arena);
+}
+#endif  // V4_NO_MALLOC
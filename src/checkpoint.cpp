@@ -0,0 +1,169 @@
+// src/checkpoint.cpp — incremental checkpoint/rollback of primary VM RAM
+#include <stdlib.h>
+#include <string.h>
+
+#include "v4/errors.hpp"
+#include "v4/internal/alloc.hpp"
+#include "v4/internal/cow_mem.hpp"
+#include "v4/internal/memory.hpp"
+#include "v4/internal/vm.h"
+#include "v4/vm_api.h"
+
+/*
+ * Undo log at page granularity: the first store into a page after a
+ * checkpoint appends its index to ckpt_dirty and saves the page into the
+ * matching slot of ckpt_shadow. Both grow with the pages written, so
+ * neither memory nor the cost of rollback and the next checkpoint scales
+ * with RAM size (sparse V4_MEM_PAGED RAM may span gigabytes).
+ */
+
+static const v4_u32 kPage = 1u << V4_CKPT_PAGE_SHIFT;
+static const uint32_t kInitSlots = 16;
+
+static inline v4_u32 page_count(const Vm *vm)
+{
+  return (vm->mem_size + kPage - 1) >> V4_CKPT_PAGE_SHIFT;
+}
+
+static inline size_t bits_bytes(const Vm *vm)
+{
+  return sizeof(uint32_t) * ((page_count(vm) + 31) / 32);
+}
+
+static inline v4_u32 page_bytes(const Vm *vm, v4_u32 page)
+{
+  const v4_u32 off = page << V4_CKPT_PAGE_SHIFT;
+  return vm->mem_size - off < kPage ? vm->mem_size - off : kPage;
+}
+
+/* Page pool followed by its index, cap slots each. One block, so a failed
+ * resize leaves the old one intact. */
+static inline size_t slots_bytes(uint32_t cap)
+{
+  return (size_t)cap * (kPage + sizeof(uint32_t));
+}
+
+/* Move the saved pages into a pool of cap slots (0 frees it). */
+static bool resize_slots(Vm *vm, uint32_t cap)
+{
+  uint8_t *block = nullptr;
+  if (cap > 0)
+  {
+    block = (uint8_t *)v4_alloc(vm->arena, slots_bytes(cap));
+    if (!block)
+      return false;
+    if (vm->ckpt_count > 0)
+    {
+      memcpy(block, vm->ckpt_shadow, (size_t)vm->ckpt_count * kPage);
+      memcpy(block + (size_t)cap * kPage, vm->ckpt_dirty,
+             sizeof(uint32_t) * vm->ckpt_count);
+    }
+  }
+  v4_dealloc(vm->arena, vm->ckpt_shadow, slots_bytes(vm->ckpt_cap));
+  vm->ckpt_shadow = block;
+  vm->ckpt_dirty = block ? (uint32_t *)(void *)(block + (size_t)cap * kPage) : nullptr;
+  vm->ckpt_cap = cap;
+  return true;
+}
+
+void v4_ckpt_touch(Vm *vm, v4_u32 addr, v4_u32 len)
+{
+  // Masked-mode tail bytes and out-of-range guarded stores are not RAM
+  if (addr >= vm->mem_size || len == 0)
+    return;
+  const uint64_t end = (uint64_t)addr + len;
+  const v4_u32 last = (v4_u32)((end < vm->mem_size ? end : vm->mem_size) - 1);
+
+  for (v4_u32 pg = addr >> V4_CKPT_PAGE_SHIFT; pg <= last >> V4_CKPT_PAGE_SHIFT; pg++)
+  {
+    uint32_t &word = vm->ckpt_bits[pg >> 5];
+    const uint32_t bit = 1u << (pg & 31);
+    if (word & bit)
+      continue;
+    if (vm->ckpt_count == vm->ckpt_cap)
+    {
+      const uint32_t pages = page_count(vm);
+      const uint32_t cap = vm->ckpt_cap > pages / 2 ? pages : 2 * vm->ckpt_cap;
+      if (vm->ckpt_lost || !resize_slots(vm, cap))
+      {
+        vm->ckpt_lost = 1;  // the store goes ahead; vm_rollback() refuses
+        return;
+      }
+    }
+    word |= bit;
+    const v4_u32 off = pg << V4_CKPT_PAGE_SHIFT;
+    memcpy(vm->ckpt_shadow + (size_t)vm->ckpt_count * kPage, vm->mem + off,
+           page_bytes(vm, pg));
+    vm->ckpt_dirty[vm->ckpt_count++] = pg;
+  }
+}
+
+/* Forget the dirty set: the current RAM contents become the checkpoint. */
+static void clear_dirty(Vm *vm)
+{
+  for (uint32_t i = 0; i < vm->ckpt_count; i++)
+  {
+    const uint32_t pg = vm->ckpt_dirty[i];
+    vm->ckpt_bits[pg >> 5] &= ~(1u << (pg & 31));
+  }
+  vm->ckpt_count = 0;
+  vm->ckpt_lost = 0;
+}
+
+extern "C" v4_err vm_checkpoint(struct Vm *vm)
+{
+  if (!vm || !vm->mem || vm->mem_size == 0)
+    return V4_ERR(InvalidArg);
+
+  if (vm->ckpt_bits)
+  {
+    clear_dirty(vm);
+    return V4_ERR(OK);
+  }
+
+  // First checkpoint: a few page slots up front, more as pages get written
+  const v4_u32 pages = page_count(vm);
+  vm->ckpt_bits = (uint32_t *)v4_alloc(vm->arena, bits_bytes(vm));
+  if (!vm->ckpt_bits || !resize_slots(vm, pages < kInitSlots ? pages : kInitSlots))
+  {
+    vm_checkpoint_end(vm);
+    return V4_ERR(NoMemory);
+  }
+  memset(vm->ckpt_bits, 0, bits_bytes(vm));
+  vm->ckpt_count = 0;
+  vm->ckpt_lost = 0;
+  vm->write_watch |= V4_WATCH_CKPT;
+  return V4_ERR(OK);
+}
+
+extern "C" v4_err vm_rollback(struct Vm *vm)
+{
+  if (!vm || !vm->ckpt_bits)
+    return V4_ERR(InvalidArg);
+  if (vm->ckpt_lost)
+    return V4_ERR(NoMemory);
+
+  for (uint32_t i = 0; i < vm->ckpt_count; i++)
+  {
+    const uint32_t pg = vm->ckpt_dirty[i];
+    memcpy(vm->mem + (pg << V4_CKPT_PAGE_SHIFT), vm->ckpt_shadow + (size_t)i * kPage,
+           page_bytes(vm, pg));
+  }
+  if (vm->ckpt_count > 0)
+    v4_cow_release(vm);  // a fork image may hold the undone writes
+  clear_dirty(vm);
+  return V4_ERR(OK);
+}
+
+extern "C" void vm_checkpoint_end(struct Vm *vm)
+{
+  if (!vm)
+    return;
+  // Reverse allocation order, so an arena can take the space back
+  resize_slots(vm, 0);
+  v4_dealloc(vm->arena, vm->ckpt_bits, bits_bytes(vm));
+  vm->ckpt_bits = nullptr;
+  vm->ckpt_count = 0;
+  vm->ckpt_lost = 0;
+  vm->write_watch &= (uint8_t)~V4_WATCH_CKPT;
+}
@@ -0,0 +1,313 @@
+// src/checksum.cpp — CRC / hash kernels over VM memory ranges
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "v4/errors.hpp"
+#include "v4/internal/sys_kernels.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define V4_CRC32C_SSE42 1
+#endif
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+/*
+ * Table width: slicing-by-8 on 64-bit hosts (8 KB per polynomial, several
+ * GB/s), a single 1 KB table on 32-bit MCUs where flash is scarce.
+ */
+#if UINTPTR_MAX > 0xFFFFFFFFu
+#define V4_CRC_SLICES 8
+#else
+#define V4_CRC_SLICES 1
+#endif
+
+/* ---- Little-endian helper ---- */
+static inline uint32_t ld_le32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t rotl32(uint32_t x, int r)
+{
+  return (x << r) | (x >> (32 - r));
+}
+
+/* ========================================================================= */
+/* CRC-32 / CRC-32C (reflected, table driven)                                */
+/* ========================================================================= */
+
+struct Crc32Tables
+{
+  uint32_t t[V4_CRC_SLICES][256];
+};
+
+static constexpr Crc32Tables make_crc32_tables(uint32_t poly)
+{
+  Crc32Tables tab{};
+  for (uint32_t i = 0; i < 256; ++i)
+  {
+    uint32_t c = i;
+    for (int k = 0; k < 8; ++k)
+      c = (c & 1u) ? (c >> 1) ^ poly : (c >> 1);
+    tab.t[0][i] = c;
+  }
+  for (int s = 1; s < V4_CRC_SLICES; ++s)
+    for (uint32_t i = 0; i < 256; ++i)
+      tab.t[s][i] = (tab.t[s - 1][i] >> 8) ^ tab.t[0][tab.t[s - 1][i] & 0xFFu];
+  return tab;
+}
+
+static constexpr Crc32Tables kCrc32 = make_crc32_tables(0xEDB88320u);
+static constexpr Crc32Tables kCrc32c = make_crc32_tables(0x82F63B78u);
+
+/* Raw (non-inverted) CRC update shared by both polynomials. */
+static uint32_t crc32_update(const Crc32Tables &tab, uint32_t crc, const uint8_t *p,
+                             size_t len)
+{
+#if V4_CRC_SLICES == 8
+  while (len >= 8)
+  {
+    const uint32_t one = ld_le32(p) ^ crc;
+    const uint32_t two = ld_le32(p + 4);
+    crc = tab.t[7][one & 0xFFu] ^ tab.t[6][(one >> 8) & 0xFFu] ^
+          tab.t[5][(one >> 16) & 0xFFu] ^ tab.t[4][one >> 24] ^ tab.t[3][two & 0xFFu] ^
+          tab.t[2][(two >> 8) & 0xFFu] ^ tab.t[1][(two >> 16) & 0xFFu] ^
+          tab.t[0][two >> 24];
+    p += 8;
+    len -= 8;
+  }
+#endif
+  while (len--)
+    crc = tab.t[0][(crc ^ *p++) & 0xFFu] ^ (crc >> 8);
+  return crc;
+}
+
+#ifdef V4_CRC32C_SSE42
+__attribute__((target("sse4.2"))) static uint32_t crc32c_sse42(uint32_t crc,
+                                                              const uint8_t *p,
+                                                              size_t len)
+{
+  uint64_t c = crc;
+  while (len >= 8)
+  {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    c = _mm_crc32_u64(c, v);
+    p += 8;
+    len -= 8;
+  }
+  uint32_t c32 = (uint32_t)c;
+  while (len--)
+    c32 = _mm_crc32_u8(c32, *p++);
+  return c32;
+}
+
+static bool cpu_has_sse42()
+{
+  static const bool has = __builtin_cpu_supports("sse4.2");
+  return has;
+}
+#endif
+
+uint32_t v4_crc32(uint32_t crc, const uint8_t *p, size_t len)
+{
+#if defined(__ARM_FEATURE_CRC32)
+  crc = ~crc;
+  while (len >= 4)
+  {
+    crc = __crc32w(crc, ld_le32(p));
+    p += 4;
+    len -= 4;
+  }
+  while (len--)
+    crc = __crc32b(crc, *p++);
+  return ~crc;
+#else
+  return ~crc32_update(kCrc32, ~crc, p, len);
+#endif
+}
+
+uint32_t v4_crc32c(uint32_t crc, const uint8_t *p, size_t len)
+{
+#if defined(V4_CRC32C_SSE42)
+  if (cpu_has_sse42())
+    return ~crc32c_sse42(~crc, p, len);
+#elif defined(__ARM_FEATURE_CRC32)
+  crc = ~crc;
+  while (len >= 4)
+  {
+    crc = __crc32cw(crc, ld_le32(p));
+    p += 4;
+    len -= 4;
+  }
+  while (len--)
+    crc = __crc32cb(crc, *p++);
+  return ~crc;
+#endif
+  return ~crc32_update(kCrc32c, ~crc, p, len);
+}
+
+/* ========================================================================= */
+/* CRC-16/CCITT (poly 0x1021, MSB first, no final XOR)                       */
+/* ========================================================================= */
+
+struct Crc16Table
+{
+  uint16_t t[256];
+};
+
+static constexpr Crc16Table make_crc16_table()
+{
+  Crc16Table tab{};
+  for (uint32_t i = 0; i < 256; ++i)
+  {
+    uint16_t c = (uint16_t)(i << 8);
+    for (int k = 0; k < 8; ++k)
+      c = (c & 0x8000u) ? (uint16_t)((c << 1) ^ 0x1021u) : (uint16_t)(c << 1);
+    tab.t[i] = c;
+  }
+  return tab;
+}
+
+static constexpr Crc16Table kCrc16 = make_crc16_table();
+
+uint16_t v4_crc16_ccitt(uint16_t crc, const uint8_t *p, size_t len)
+{
+  while (len--)
+    crc = (uint16_t)((crc << 8) ^ kCrc16.t[((crc >> 8) ^ *p++) & 0xFFu]);
+  return crc;
+}
+
+/* ========================================================================= */
+/* FNV-1a (32-bit)                                                           */
+/* ========================================================================= */
+
+uint32_t v4_fnv1a32(uint32_t h, const uint8_t *p, size_t len)
+{
+  while (len--)
+  {
+    h ^= *p++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+/* ========================================================================= */
+/* xxHash32                                                                  */
+/* ========================================================================= */
+
+static const uint32_t XXH_P1 = 2654435761u;
+static const uint32_t XXH_P2 = 2246822519u;
+static const uint32_t XXH_P3 = 3266489917u;
+static const uint32_t XXH_P4 = 668265263u;
+static const uint32_t XXH_P5 = 374761393u;
+
+static inline uint32_t xxh32_round(uint32_t acc, uint32_t lane)
+{
+  acc += lane * XXH_P2;
+  acc = rotl32(acc, 13);
+  return acc * XXH_P1;
+}
+
+uint32_t v4_xxh32(uint32_t seed, const uint8_t *p, size_t len)
+{
+  const uint8_t *const end = p + len;
+  uint32_t h;
+
+  if (len >= 16)
+  {
+    uint32_t v1 = seed + XXH_P1 + XXH_P2;
+    uint32_t v2 = seed + XXH_P2;
+    uint32_t v3 = seed;
+    uint32_t v4 = seed - XXH_P1;
+    const uint8_t *const limit = end - 16;
+    do
+    {
+      v1 = xxh32_round(v1, ld_le32(p));
+      v2 = xxh32_round(v2, ld_le32(p + 4));
+      v3 = xxh32_round(v3, ld_le32(p + 8));
+      v4 = xxh32_round(v4, ld_le32(p + 12));
+      p += 16;
+    } while (p <= limit);
+    h = rotl32(v1, 1) + rotl32(v2, 7) + rotl32(v3, 12) + rotl32(v4, 18);
+  }
+  else
+  {
+    h = seed + XXH_P5;
+  }
+
+  h += (uint32_t)len;
+
+  while (p + 4 <= end)
+  {
+    h += ld_le32(p) * XXH_P3;
+    h = rotl32(h, 17) * XXH_P4;
+    p += 4;
+  }
+  while (p < end)
+  {
+    h += (*p++) * XXH_P5;
+    h = rotl32(h, 11) * XXH_P1;
+  }
+
+  h ^= h >> 15;
+  h *= XXH_P2;
+  h ^= h >> 13;
+  h *= XXH_P3;
+  h ^= h >> 16;
+  return h;
+}
+
+/* ========================================================================= */
+/* SYS kernels: ( addr len seed -- value )                                   */
+/* ========================================================================= */
+
+v4_err v4_k_crc32(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  uint8_t *p;
+  if (v4_err e = v4_kernel_range(vm, in[0], in[1], &p))
+    return e;
+  out[0] = (v4_i32)v4_crc32((uint32_t)in[2], p, (v4_u32)in[1]);
+  return V4_ERR(OK);
+}
+
+v4_err v4_k_crc32c(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  uint8_t *p;
+  if (v4_err e = v4_kernel_range(vm, in[0], in[1], &p))
+    return e;
+  out[0] = (v4_i32)v4_crc32c((uint32_t)in[2], p, (v4_u32)in[1]);
+  return V4_ERR(OK);
+}
+
+v4_err v4_k_crc16_ccitt(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  uint8_t *p;
+  if (v4_err e = v4_kernel_range(vm, in[0], in[1], &p))
+    return e;
+  out[0] = (v4_i32)v4_crc16_ccitt((uint16_t)in[2], p, (v4_u32)in[1]);
+  return V4_ERR(OK);
+}
+
+v4_err v4_k_fnv1a32(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  uint8_t *p;
+  if (v4_err e = v4_kernel_range(vm, in[0], in[1], &p))
+    return e;
+  out[0] = (v4_i32)v4_fnv1a32((uint32_t)in[2], p, (v4_u32)in[1]);
+  return V4_ERR(OK);
+}
+
+v4_err v4_k_xxh32(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  uint8_t *p;
+  if (v4_err e = v4_kernel_range(vm, in[0], in[1], &p))
+    return e;
+  out[0] = (v4_i32)v4_xxh32((uint32_t)in[2], p, (v4_u32)in[1]);
+  return V4_ERR(OK);
+}
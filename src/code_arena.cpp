@@ -0,0 +1,381 @@
+// src/code_arena.cpp — VM-owned bytecode arena, call profile and word layout
+#include <stdint.h>
+#include <string.h>
+
+#include "v4/errors.hpp"
+#include "v4/internal/alloc.hpp"
+#include "v4/internal/code_arena.hpp"
+#include "v4/internal/vm.h"
+#include "v4/opcodes.hpp"
+#include "v4/vm_api.h"
+
+/*
+ * Words registered through vm_register_word() normally run from wherever
+ * the host kept their bytecode. With a code arena they are copied into one
+ * aligned block instead, so a program's code is dense, and
+ * vm_relayout_words() can then choose the order of that block: a caller is
+ * followed by the callees it reaches first, so a CALL usually lands on a line
+ * that is already cached.
+ */
+
+namespace
+{
+const v4_u32 kLine = V4_CODE_LINE;
+
+/* Immediate bytes per opcode kind; JMPTBL is sized from its count. */
+const int kImm_NO_IMM = 0;
+const int kImm_IMM8 = 1;
+const int kImm_IMM16 = 2;
+const int kImm_IMM32 = 4;
+const int kImm_REL16 = 2;
+const int kImm_IDX16 = 2;
+const int kImm_TBL16 = -2;
+
+int imm_len(uint8_t op)
+{
+  switch (op)
+  {
+#define OP(name, val, kind) \
+  case val:                 \
+    return kImm_##kind;
+#include <v4/opcodes.def>
+#undef OP
+    default:
+      return -1;
+  }
+}
+
+/* CALL targets in bytecode, in site order, stored to out when non-NULL.
+ * Decoding stops at an unknown opcode or a truncated instruction. */
+int scan_calls(const uint8_t *p, int len, uint64_t *out)
+{
+  const uint8_t *end = p + len;
+  int n = 0;
+  while (p < end)
+  {
+    const uint8_t op = *p++;
+    int imm = imm_len(op);
+    if (imm == kImm_TBL16)
+    {
+      if (end - p < 4)
+        break;
+      imm = 4 + 2 * (p[0] | (p[1] << 8));
+    }
+    if (imm < 0 || end - p < imm)
+      break;
+    if (op == (uint8_t)v4::Op::CALL)
+    {
+      if (out)
+        out[n] = (uint16_t)(p[0] | (p[1] << 8));
+      n++;
+    }
+    p += imm;
+  }
+  return n;
+}
+
+/* Offset for len bytes at or after off: a copy that fits in one line never
+ * straddles two. */
+uint64_t place(uint64_t off, v4_u32 len)
+{
+  const v4_u32 in_line = (v4_u32)off & (kLine - 1);
+  if (len <= kLine && in_line + len > kLine)
+    return off + (kLine - in_line);
+  return off;
+}
+
+bool owned(const Vm *vm, int i)
+{
+  const uint8_t *c = v4_dict_word(vm, i)->code;
+  return vm->code_mem && c >= vm->code_mem && c < vm->code_mem + vm->code_used;
+}
+
+/* Ascending heapsort: in place, no libc sort that may allocate. */
+void sort_u64(uint64_t *a, int n)
+{
+  for (int end = n, start = n / 2; end > 1;)
+  {
+    if (start > 0)
+    {
+      start--;
+    }
+    else
+    {
+      end--;
+      const uint64_t t = a[0];
+      a[0] = a[end];
+      a[end] = t;
+    }
+    int root = start;
+    for (int child; (child = 2 * root + 1) < end; root = child)
+    {
+      if (child + 1 < end && a[child + 1] > a[child])
+        child++;
+      if (a[root] >= a[child])
+        break;
+      const uint64_t t = a[root];
+      a[root] = a[child];
+      a[child] = t;
+    }
+  }
+}
+
+struct Layout
+{
+  int n;
+  bool profiled;
+  uint64_t *edges; /* callee per CALL site, first[u]..first[u + 1] */
+  int32_t *first;
+  v4_u32 *rank;    /* call count when profiled, else static in-degree */
+  int32_t *cursor; /* next edge of a placed word; -1 unplaced, -2 not owned */
+  int32_t *stack;
+  int32_t *order;
+  int placed;
+};
+
+/* Depth-first from root: each word is followed by its first unplaced callee. */
+void visit(Layout &l, int root)
+{
+  int sp = 0;
+  l.cursor[root] = l.first[root];
+  l.order[l.placed++] = root;
+  l.stack[sp++] = root;
+  while (sp > 0)
+  {
+    const int u = l.stack[sp - 1];
+    if (l.cursor[u] == l.first[u + 1])
+    {
+      sp--;
+      continue;
+    }
+    const uint32_t v = (uint32_t)l.edges[l.cursor[u]++];
+    if (v >= (uint32_t)l.n || l.cursor[v] != -1 || (l.profiled && l.rank[v] == 0))
+      continue;
+    l.cursor[v] = l.first[v];
+    l.order[l.placed++] = (int32_t)v;
+    l.stack[sp++] = (int32_t)v;
+  }
+}
+}  // namespace
+
+const uint8_t *v4_code_copy(Vm *vm, const uint8_t *code, int len)
+{
+  if (!vm->code_mem)
+  {
+    if ((size_t)vm->code_size > SIZE_MAX - kLine)
+      return nullptr;
+    void *b = v4_alloc(vm->arena, (size_t)vm->code_size + kLine - 1);
+    if (!b)
+      return nullptr;
+    vm->code_block = b;
+    vm->code_mem = (uint8_t *)(((uintptr_t)b + kLine - 1) & ~(uintptr_t)(kLine - 1));
+    vm->code_used = 0;
+  }
+  const uint64_t at = place(vm->code_used, (v4_u32)len);
+  if (at + (v4_u32)len > vm->code_size)
+    return nullptr;
+  memcpy(vm->code_mem + at, code, (size_t)len);
+  vm->code_used = (v4_u32)(at + (v4_u32)len);
+  return vm->code_mem + at;
+}
+
+void v4_code_free(Vm *vm)
+{
+  v4_dealloc(vm->arena, vm->code_block, (size_t)vm->code_size + kLine - 1);
+  vm->code_block = nullptr;
+  vm->code_mem = nullptr;
+  vm->code_used = 0;
+}
+
+bool v4_word_calls_resize(Vm *vm, int cap)
+{
+  if (!vm->word_calls)
+    return true;
+  const size_t old_bytes = sizeof(v4_u32) * (size_t)vm->word_calls_cap;
+  if (cap == 0)
+  {
+    v4_dealloc(vm->arena, vm->word_calls, old_bytes);
+    vm->word_calls = nullptr;
+    vm->word_calls_cap = 0;
+    vm->word_profile = 0;
+    return true;
+  }
+  v4_u32 *c = (v4_u32 *)v4_realloc(vm->arena, vm->word_calls, old_bytes,
+                                   sizeof(v4_u32) * (size_t)cap);
+  if (!c)
+    return false;
+  if (cap > vm->word_calls_cap)
+    memset(c + vm->word_calls_cap, 0,
+           sizeof(v4_u32) * (size_t)(cap - vm->word_calls_cap));
+  vm->word_calls = c;
+  vm->word_calls_cap = cap;
+  return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Public API                                                                */
+/* ------------------------------------------------------------------------- */
+
+extern "C" v4_err vm_word_profile(Vm *vm, int enable)
+{
+  if (!vm)
+    return V4_ERR(InvalidArg);
+#ifdef V4_WORD_PROFILE
+  if (enable)
+  {
+    // Kept at least word_cap long by dict_grow() from here on
+    if (!vm->word_calls)
+    {
+      const int cap = vm->word_cap > 0 ? vm->word_cap : 1;
+      vm->word_calls = (v4_u32 *)v4_alloc(vm->arena, sizeof(v4_u32) * (size_t)cap);
+      if (!vm->word_calls)
+        return V4_ERR(NoMemory);
+      vm->word_calls_cap = cap;
+    }
+    memset(vm->word_calls, 0, sizeof(v4_u32) * (size_t)vm->word_calls_cap);
+  }
+  vm->word_profile = enable ? 1 : 0;
+  return V4_ERR(OK);
+#else
+  (void)enable;
+  return V4_ERR(InvalidArg);  // CALL carries no counting code in this build
+#endif
+}
+
+extern "C" v4_u32 vm_word_get_calls(Vm *vm, int idx)
+{
+  if (!vm || idx < 0 || idx >= vm->word_count || idx >= vm->word_calls_cap)
+    return 0;
+  return vm->word_calls[idx];
+}
+
+extern "C" v4_err vm_relayout_words(Vm *vm, const v4_u32 *calls, int count)
+{
+  if (!vm || count < 0 || (count > 0 && !calls))
+    return V4_ERR(InvalidArg);
+  if (vm->fork_count > 0)
+    return V4_ERR(InvalidArg);  // forks execute the arena in place
+  const int n = vm->word_count;
+  if (!vm->code_mem || vm->code_used == 0)
+    return V4_ERR(OK);
+
+  int edge_count = 0;
+  for (int i = 0; i < n; i++)
+    if (owned(vm, i))
+    {
+      const Word *w = v4_dict_word(vm, i);
+      edge_count += scan_calls(w->code, w->code_len, nullptr);
+    }
+
+  // One scratch block: 64-bit arrays first, then 32-bit ones
+  const size_t bytes = sizeof(uint64_t) * ((size_t)n + (size_t)edge_count) +
+                       sizeof(int32_t) * (5 * (size_t)n + 1);
+  uint64_t *keys = (uint64_t *)v4_alloc(vm->arena, bytes);
+  if (!keys)
+    return V4_ERR(NoMemory);
+  Layout l;
+  l.n = n;
+  l.profiled = false;
+  l.edges = keys + n;
+  l.first = (int32_t *)(l.edges + edge_count);
+  l.rank = (v4_u32 *)(l.first + n + 1);
+  l.cursor = (int32_t *)(l.rank + n);
+  l.stack = l.cursor + n;
+  l.order = l.stack + n;
+  l.placed = 0;
+
+  l.first[0] = 0;
+  for (int i = 0; i < n; i++)
+  {
+    const bool own = owned(vm, i);
+    const Word *w = v4_dict_word(vm, i);
+    const int k = own ? scan_calls(w->code, w->code_len, l.edges + l.first[i]) : 0;
+    l.first[i + 1] = l.first[i] + k;
+    l.cursor[i] = own ? -1 : -2;
+    if (!own)
+      l.rank[i] = 0;
+    else if (calls)
+      l.rank[i] = i < count ? calls[i] : 0;
+    else
+      l.rank[i] = i < vm->word_calls_cap ? vm->word_calls[i] : 0;
+    if (l.rank[i])
+      l.profiled = true;
+  }
+
+  int roots = 0;
+  if (l.profiled)
+  {
+    // Hottest first; callees in descending heat, cold ones never followed
+    for (int u = 0; u < n; u++)
+    {
+      for (int e = l.first[u]; e < l.first[u + 1]; e++)
+      {
+        const uint32_t v = (uint32_t)l.edges[e];
+        const v4_u32 heat = v < (uint32_t)n ? l.rank[v] : 0;
+        l.edges[e] = ((uint64_t)(UINT32_MAX - heat) << 32) | v;
+      }
+      sort_u64(l.edges + l.first[u], l.first[u + 1] - l.first[u]);
+      if (l.rank[u])
+        keys[roots++] = ((uint64_t)(UINT32_MAX - l.rank[u]) << 32) | (uint32_t)u;
+    }
+  }
+  else
+  {
+    // Entry points first (fewest callers), newest definitions first
+    for (int e = 0; e < edge_count; e++)
+    {
+      const uint32_t v = (uint32_t)l.edges[e];
+      if (v < (uint32_t)n && l.cursor[v] == -1)
+        l.rank[v]++;
+    }
+    for (int u = 0; u < n; u++)
+      if (l.cursor[u] == -1)
+        keys[roots++] = ((uint64_t)l.rank[u] << 32) | (UINT32_MAX - (uint32_t)u);
+  }
+  sort_u64(keys, roots);
+  for (int r = 0; r < roots; r++)
+  {
+    const uint32_t low = (uint32_t)keys[r];
+    const int u = (int)(l.profiled ? low : UINT32_MAX - low);
+    if (l.cursor[u] == -1)
+      visit(l, u);
+  }
+  for (int u = 0; u < n; u++)  // never called under the profile
+    if (l.cursor[u] == -1)
+    {
+      l.cursor[u] = 0;
+      l.order[l.placed++] = u;
+    }
+
+  // New offsets (in the stack, free again), then rewrite the arena via a copy
+  v4_u32 *at = (v4_u32 *)l.stack;
+  uint64_t end = 0;
+  for (int j = 0; j < l.placed; j++)
+  {
+    const v4_u32 len = (v4_u32)v4_dict_word(vm, l.order[j])->code_len;
+    const uint64_t off = place(end, len);
+    end = off + len;
+    at[j] = (v4_u32)off;
+  }
+  uint8_t *buf =
+      end <= vm->code_size ? (uint8_t *)v4_alloc(vm->arena, (size_t)end) : nullptr;
+  if (!buf)
+  {
+    v4_dealloc(vm->arena, keys, bytes);
+    return V4_ERR(NoMemory);
+  }
+  memset(buf, 0, (size_t)end);
+  for (int j = 0; j < l.placed; j++)
+  {
+    const Word &w = *v4_dict_word(vm, l.order[j]);
+    memcpy(buf + at[j], w.code, (size_t)w.code_len);
+  }
+  memcpy(vm->code_mem, buf, (size_t)end);
+  for (int j = 0; j < l.placed; j++)
+    v4_dict_word(vm, l.order[j])->code = vm->code_mem + at[j];
+  vm->code_used = (v4_u32)end;
+
+  v4_dealloc(vm->arena, buf, (size_t)end);
+  v4_dealloc(vm->arena, keys, bytes);
+  return V4_ERR(OK);
+}
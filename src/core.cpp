@@ -7,7 +7,12 @@
 #include "v4/arena.h"
 #include "v4/errors.hpp"
 #include "v4/hal.h"
+#include "v4/internal/alloc.hpp"
+#include "v4/internal/code_arena.hpp"
+#include "v4/internal/guard_mem.hpp"
+#include "v4/internal/mem_file.hpp"
 #include "v4/internal/memory.hpp"
+#include "v4/internal/sys_kernels.hpp"
 #include "v4/internal/vm.h"
 #include "v4/opcodes.hpp"
 #include "v4/sys_ids.h"
@@ -41,18 +46,34 @@ extern "C" void vm_reset_dictionary(Vm* vm)
   // Free word names only if using malloc (not arena)
   if (!vm->arena)
   {
-    for (int i = 0; i < vm->word_count; i++)
+    for (int i = vm->dict_base; i < vm->word_count; i++)
     {
-      if (vm->words[i].name)
+      WordName* w = v4_word_name(v4_dict_word(vm, i));
+      if (w->name)
       {
-        free(vm->words[i].name);
-        vm->words[i].name = nullptr;
+        v4_dealloc(nullptr, w->name, 0);
+        w->name = nullptr;
       }
     }
   }
   // If using arena, names are managed by arena owner
 
+  // Keep an arena-backed index for reuse; heap tables are dropped
+  if (vm->arena && vm->dict_index)
+    memset(vm->dict_index, 0xFF, sizeof(int32_t) * (size_t)vm->dict_index_cap);
+  else
+    v4_dict_index_free(vm);
+  v4_word_calls_resize(vm, 0);
+
+  // Heap builds hand the entries back; an arena could not reclaim them
+#ifndef V4_NO_MALLOC
+  v4_dict_free(vm);
+  v4_code_free(vm);
+#endif
+  vm->code_used = 0;
+
   vm->word_count = 0;
+  vm->dict_base = 0;
 }
 
 extern "C" void vm_reset_stacks(Vm* vm)
@@ -141,9 +162,48 @@ static inline int16_t read_i16_le(const v4_u8* p)
   return (int16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
 }
 
+template <V4MemPath P>
+static v4_err exec_loop(Vm* vm, const v4_u8* bc, int len);
+
+/* Run a word with its own local frame (shared by CALL and EXECUTE). */
+template <V4MemPath P>
+static inline v4_err call_word(Vm* vm, const Word* word)
+{
+  // Save current frame pointer (for nested calls)
+  v4_i32* old_fp = vm->fp;
+
+  // Set new frame pointer to current return stack position
+  // This allows local variables to be accessed relative to the frame base
+  vm->fp = vm->rp;
+
+  // Execute the called word
+  v4_err e = exec_loop<P>(vm, word->code, word->code_len);
+
+  // Restore frame pointer after call returns
+  vm->fp = old_fp;
+  return e;
+}
+
 /* =================== Internal raw bytecode interpreter =================== */
 
 extern "C" v4_err vm_exec_raw(Vm* vm, const v4_u8* bc, int len)
+{
+  // The RAM access path is fixed for the whole run. Outermost entry on
+  // guard-page RAM arms fault recovery; nested CALLs and EXECUTEs run under
+  // the same frame.
+#ifdef V4_HAVE_GUARDED_MEM
+  if (vm->guard_frame)
+    return exec_loop<V4_MEM_PATH_GUARDED>(vm, bc, len);
+  if (vm->guard_base)
+    return v4_guard_exec(vm, bc, len, exec_loop<V4_MEM_PATH_GUARDED>);
+#endif
+  if (vm->mem_mask)
+    return exec_loop<V4_MEM_PATH_MASKED>(vm, bc, len);
+  return exec_loop<V4_MEM_PATH_CHECKED>(vm, bc, len);
+}
+
+template <V4MemPath P>
+static v4_err exec_loop(Vm* vm, const v4_u8* bc, int len)
 {
   assert(vm && bc && len > 0);
   const v4_u8* ip = bc;
@@ -568,6 +628,29 @@ extern "C" v4_err vm_exec_raw(Vm* vm, const v4_u8* bc, int len)
         break;
       }
 
+      case v4::Op::JMPTBL:
+      {
+        // Layout: count:u16 default:rel16 target[count]:rel16, all offsets
+        // relative to the first byte after the table.
+        if (ip + 4 > ip_end)
+          return vm_panic(vm, V4_ERR(TruncatedJump));
+        const v4_u32 count = (v4_u16)read_i16_le(ip);
+        const v4_u8* table = ip + 2;
+        const v4_u8* next = table + 2 + 2 * count;
+        if (next > ip_end)
+          return vm_panic(vm, V4_ERR(TruncatedJump));
+        v4_i32 idx;
+        if (v4_err e = ds_pop(vm, &idx))
+          return e;
+        // Negative indices wrap to large unsigned values and take the default
+        const v4_u32 slot = ((v4_u32)idx < count) ? (v4_u32)idx + 1 : 0;
+        const v4_u8* tgt = next + read_i16_le(table + 2 * slot);
+        if (tgt < bc || tgt > ip_end)
+          return vm_panic(vm, V4_ERR(JumpOutOfRange));
+        ip = tgt;
+        break;
+      }
+
       case v4::Op::SELECT:
       {
         v4_i32 a, b, flag;
@@ -590,7 +673,7 @@ extern "C" v4_err vm_exec_raw(Vm* vm, const v4_u8* bc, int len)
           return e;
         v4_u32 addr = (v4_u32)addr_i32;
         v4_u32 val = 0;
-        if (v4_err e = v4_mem_read32_core(vm, addr, &val))
+        if (v4_err e = v4_mem_read32_core<P>(vm, addr, &val))
           return e;
         if (v4_err e = ds_push(vm, (v4_i32)val))
           return e;
@@ -606,7 +689,7 @@ extern "C" v4_err vm_exec_raw(Vm* vm, const v4_u8* bc, int len)
           return e;
         v4_u32 addr = (v4_u32)addr_i32;
         v4_u32 val = (v4_u32)val_i32;
-        if (v4_err e = v4_mem_write32_core(vm, addr, val))
+        if (v4_err e = v4_mem_write32_core<P>(vm, addr, val))
           return e;
         break;
       }
@@ -618,7 +701,7 @@ extern "C" v4_err vm_exec_raw(Vm* vm, const v4_u8* bc, int len)
           return e;
         v4_u32 addr = (v4_u32)addr_i32;
         v4_u32 val = 0;
-        if (v4_err e = v4_mem_read8_core(vm, addr, &val))
+        if (v4_err e = v4_mem_read8_core<P>(vm, addr, &val))
           return e;
         if (v4_err e = ds_push(vm, (v4_i32)val))
           return e;
@@ -632,7 +715,7 @@ extern "C" v4_err vm_exec_raw(Vm* vm, const v4_u8* bc, int len)
           return e;
         v4_u32 addr = (v4_u32)addr_i32;
         v4_u32 val = 0;
-        if (v4_err e = v4_mem_read16_core(vm, addr, &val))
+        if (v4_err e = v4_mem_read16_core<P>(vm, addr, &val))
           return e;
         if (v4_err e = ds_push(vm, (v4_i32)val))
           return e;
@@ -648,7 +731,7 @@ extern "C" v4_err vm_exec_raw(Vm* vm, const v4_u8* bc, int len)
           return e;
         v4_u32 addr = (v4_u32)addr_i32;
         v4_u32 val = (v4_u32)val_i32;
-        if (v4_err e = v4_mem_write8_core(vm, addr, val))
+        if (v4_err e = v4_mem_write8_core<P>(vm, addr, val))
           return e;
         break;
       }
@@ -662,7 +745,7 @@ extern "C" v4_err vm_exec_raw(Vm* vm, const v4_u8* bc, int len)
           return e;
         v4_u32 addr = (v4_u32)addr_i32;
         v4_u32 val = (v4_u32)val_i32;
-        if (v4_err e = v4_mem_write16_core(vm, addr, val))
+        if (v4_err e = v4_mem_write16_core<P>(vm, addr, val))
           return e;
         break;
       }
@@ -674,7 +757,7 @@ extern "C" v4_err vm_exec_raw(Vm* vm, const v4_u8* bc, int len)
           return e;
         v4_u32 addr = (v4_u32)addr_i32;
         v4_u32 val = 0;
-        if (v4_err e = v4_mem_read8_core(vm, addr, &val))
+        if (v4_err e = v4_mem_read8_core<P>(vm, addr, &val))
           return e;
         // Sign-extend 8-bit to 32-bit
         int8_t val_i8 = (int8_t)(val & 0xFF);
@@ -690,7 +773,7 @@ extern "C" v4_err vm_exec_raw(Vm* vm, const v4_u8* bc, int len)
           return e;
         v4_u32 addr = (v4_u32)addr_i32;
         v4_u32 val = 0;
-        if (v4_err e = v4_mem_read16_core(vm, addr, &val))
+        if (v4_err e = v4_mem_read16_core<P>(vm, addr, &val))
           return e;
         // Sign-extend 16-bit to 32-bit
         int16_t val_i16 = (int16_t)(val & 0xFFFF);
@@ -699,6 +782,69 @@ extern "C" v4_err vm_exec_raw(Vm* vm, const v4_u8* bc, int len)
         break;
       }
 
+      /* -------- Atomic cells (shared memory) -------- */
+      case v4::Op::ALOAD:
+      {
+        v4_i32 addr_i32;
+        if (v4_err e = ds_pop(vm, &addr_i32))
+          return e;
+        v4_u32 val = 0;
+        if (v4_err e = v4_mem_aload32(vm, (v4_u32)addr_i32, &val))
+          return e;
+        if (v4_err e = ds_push(vm, (v4_i32)val))
+          return e;
+        break;
+      }
+
+      case v4::Op::ASTORE:
+      {
+        v4_i32 addr_i32, val_i32;
+        if (v4_err e = ds_pop(vm, &addr_i32))
+          return e;
+        if (v4_err e = ds_pop(vm, &val_i32))
+          return e;
+        if (v4_err e = v4_mem_astore32(vm, (v4_u32)addr_i32, (v4_u32)val_i32))
+          return e;
+        break;
+      }
+
+      case v4::Op::CAS:
+      {
+        v4_i32 addr_i32, desired, expected;
+        if (v4_err e = ds_pop(vm, &addr_i32))
+          return e;
+        if (v4_err e = ds_pop(vm, &desired))
+          return e;
+        if (v4_err e = ds_pop(vm, &expected))
+          return e;
+        v4_u32 old = 0;
+        if (v4_err e = v4_mem_cas32(vm, (v4_u32)addr_i32, (v4_u32)expected,
+                                    (v4_u32)desired, &old))
+          return e;
+        if (v4_err e = ds_push(vm, (v4_i32)old))
+          return e;
+        break;
+      }
+
+      case v4::Op::AADD:
+      {
+        v4_i32 addr_i32, n;
+        if (v4_err e = ds_pop(vm, &addr_i32))
+          return e;
+        if (v4_err e = ds_pop(vm, &n))
+          return e;
+        v4_u32 old = 0;
+        if (v4_err e = v4_mem_aadd32(vm, (v4_u32)addr_i32, (v4_u32)n, &old))
+          return e;
+        if (v4_err e = ds_push(vm, (v4_i32)old))
+          return e;
+        break;
+      }
+
+      case v4::Op::FENCE:
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        break;
+
       /* -------- Return stack operations -------- */
       case v4::Op::TOR:
       {
@@ -912,27 +1058,40 @@ extern "C" v4_err vm_exec_raw(Vm* vm, const v4_u8* bc, int len)
         uint16_t word_idx = (uint16_t)ip[0] | ((uint16_t)ip[1] << 8);
         ip += 2;
 
-        if (word_idx >= (uint16_t)vm->word_count)
+        if ((int)word_idx >= vm->word_count)
           return vm_panic(vm, V4_ERR(InvalidWordIdx));
 
-        Word* word = &vm->words[word_idx];
+        Word* word = v4_dict_word(vm, word_idx);
         if (!word->code || word->code_len <= 0)
           return vm_panic(vm, V4_ERR(InvalidArg));
+#ifdef V4_WORD_PROFILE
+        if (vm->word_profile)
+          vm->word_calls[word_idx]++;
+#endif
 
-        // Save current frame pointer (for nested calls)
-        v4_i32* old_fp = vm->fp;
+        if (v4_err e = call_word<P>(vm, word))
+          return e;
+        break;
+      }
 
-        // Set new frame pointer to current return stack position
-        // This allows local variables to be accessed relative to the frame base
-        vm->fp = vm->rp;
+      case v4::Op::EXECUTE:
+      {
+        v4_i32 idx;
+        if (v4_err e = ds_pop(vm, &idx))
+          return e;
 
-        // Execute the called word
-        v4_err e = vm_exec_raw(vm, word->code, word->code_len);
+        if (idx < 0 || idx >= vm->word_count)
+          return vm_panic(vm, V4_ERR(InvalidWordIdx));
 
-        // Restore frame pointer after call returns
-        vm->fp = old_fp;
+        Word* word = v4_dict_word(vm, idx);
+        if (!word->code || word->code_len <= 0)
+          return vm_panic(vm, V4_ERR(InvalidArg));
+#ifdef V4_WORD_PROFILE
+        if (vm->word_profile)
+          vm->word_calls[idx]++;
+#endif
 
-        if (e)
+        if (v4_err e = call_word<P>(vm, word))
           return e;
         break;
       }
@@ -951,6 +1110,23 @@ extern "C" v4_err vm_exec_raw(Vm* vm, const v4_u8* bc, int len)
 
         uint16_t sys_id = static_cast<uint16_t>(sys_id_i32);
 
+        // Core kernels operate on VM memory ranges, so they are served here
+        // in every build (including V4-std).
+        if (const V4SysKernel* kern = v4_sys_kernel_find(sys_id))
+        {
+          v4_i32 in[V4_SYS_KERNEL_MAX_IN] = {};
+          v4_i32 out[V4_SYS_KERNEL_MAX_OUT] = {};
+          for (int i = kern->n_in - 1; i >= 0; --i)
+            if ((err = ds_pop(vm, &in[i])))
+              return err;
+          if ((err = kern->fn(vm, in, out)))
+            return vm_panic(vm, err);
+          for (int i = 0; i < kern->n_out; ++i)
+            if ((err = ds_push(vm, out[i])))
+              return err;
+          break;
+        }
+
 #ifdef V4_USE_V4STD
         // V4-std path: Use dynamic handler registry
         // Stack layout: ( arg0 arg1 arg2 -- result )
@@ -1381,62 +1557,247 @@ extern "C" v4_err vm_exec_raw(Vm* vm, const v4_u8* bc, int len)
 
 /* ======================= Word management API ============================= */
 
-extern "C" int vm_register_word(Vm* vm, const char* name, const uint8_t* code,
-                                int code_len)
+/*
+ * Name index for vm_find_word(): open addressing with linear probing. Each
+ * distinct name owns one slot holding its newest definition, so registering
+ * a name again overwrites the slot (Forth shadowing). Kept at most half full
+ * and maintained incrementally by vm_register_word(); built lazily when it
+ * is missing (forks, vm_reset_dictionary(), failed allocation).
+ */
+enum
+{
+  V4_DICT_INDEX_MIN = 64
+};
+
+static uint32_t dict_hash(const char* name, size_t len)
+{
+  return v4_fnv1a32(2166136261u, reinterpret_cast<const uint8_t*>(name), len);
+}
+
+/* Slot holding `name`, or the empty slot where it would go. */
+static int32_t* dict_slot(Vm* vm, const char* name, uint32_t h)
+{
+  const uint32_t mask = (uint32_t)vm->dict_index_cap - 1;
+  for (uint32_t i = h & mask;; i = (i + 1) & mask)
+  {
+    int32_t* s = &vm->dict_index[i];
+    if (*s < 0)
+      return s;
+    const WordName* w = v4_word_name(v4_dict_word(vm, *s));
+    if (w->hash == h && strcmp(w->name, name) == 0)
+      return s;
+  }
+}
+
+extern "C" void v4_dict_index_free(Vm* vm)
+{
+#ifdef V4_NO_MALLOC
+  v4_dealloc(vm->arena, vm->dict_index, sizeof(int32_t) * (size_t)vm->dict_index_cap);
+#else
+  if (!vm->arena)
+    v4_dealloc(nullptr, vm->dict_index, sizeof(int32_t) * (size_t)vm->dict_index_cap);
+#endif
+  vm->dict_index = nullptr;
+  vm->dict_index_cap = 0;
+}
+
+/* Make room for `names` named words, rebuilding from the dictionary when the
+ * table is (re)allocated. False if no table could be allocated. */
+static bool dict_index_reserve(Vm* vm, int names)
+{
+  if (vm->dict_index && 2 * names <= vm->dict_index_cap)
+    return true;
+
+  int cap = vm->dict_index_cap ? vm->dict_index_cap : V4_DICT_INDEX_MIN;
+  while (cap < 2 * names)
+    cap *= 2;
+  v4_dict_index_free(vm);
+  const size_t bytes = sizeof(int32_t) * (size_t)cap;
+#ifdef V4_NO_MALLOC
+  void* mem = v4_alloc(vm->arena, bytes);  // reclaimed through the free list
+#else
+  void* mem = vm->arena ? v4_arena_alloc(vm->arena, bytes, alignof(int32_t))
+                        : v4_alloc(nullptr, bytes);
+#endif
+  int32_t* t = static_cast<int32_t*>(mem);
+  if (!t)
+    return false;
+  memset(t, 0xFF, bytes);
+  vm->dict_index = t;
+  vm->dict_index_cap = cap;
+
+  // Oldest first, so the newest definition of each name ends up in its slot
+  for (int i = 0; i < vm->word_count; i++)
+  {
+    const WordName* w = v4_word_name(v4_dict_word(vm, i));
+    if (w->name)
+      *dict_slot(vm, w->name, w->hash) = i;
+  }
+  return true;
+}
+
+/* Entries in segment k (>= 1) of a dictionary with segment 0 of seg0 words. */
+static int dict_seg_len(const Vm* vm, int k)
+{
+  const int base = vm->dict_seg0 << (k - 1);
+  return base < vm->word_cap - base ? base : vm->word_cap - base;
+}
+
+/*
+ * Room for more entries: segment 0 on first use, then a new segment as large
+ * as everything before it, up to dict_max. Existing entries never move. Each
+ * segment holds its hot Words followed by their cold WordNames, so CALL walks
+ * a dense array of code pointers and lengths only.
+ */
+extern "C" bool v4_dict_grow(Vm* vm)
+{
+  int len;
+  if (vm->word_cap == 0)
+    len = vm->dict_init > 0 ? vm->dict_init : V4_DICT_DEFAULT_WORDS;
+  else if (vm->dict_max > vm->word_cap)
+    len = vm->word_cap > vm->dict_max - vm->word_cap ? vm->dict_max - vm->word_cap
+                                                     : vm->word_cap;
+  else
+    return false;
+
+  // Word::name_off must reach across the segment
+  if ((uint64_t)len * (sizeof(Word) + sizeof(WordName)) > UINT32_MAX)
+    return false;
+  if (!v4_word_calls_resize(vm, vm->word_cap + len))
+    return false;
+  Word* seg = static_cast<Word*>(v4_alloc(vm->arena, v4_dict_seg_bytes(len)));
+  if (!seg)
+    return false;
+  for (int j = 0; j < len; j++)
+    seg[j].name_off = (uint32_t)((size_t)(len - j) * sizeof(Word) +
+                                 (size_t)j * sizeof(WordName));
+  if (vm->word_cap == 0)
+  {
+    vm->words = seg;
+    vm->dict_seg0 = len;
+  }
+  else
+  {
+    // word_cap == dict_seg0 << (k - 1) for the new segment k
+    const int k = v4_ffs32((uint32_t)(vm->word_cap / vm->dict_seg0)) + 1;
+    vm->dict_seg[k - 1] = seg;
+  }
+  vm->word_cap += len;
+  return true;
+}
+
+extern "C" void v4_dict_free(Vm* vm)
+{
+  for (int k = 1; k <= V4_DICT_SEGS && vm->dict_seg[k - 1]; k++)
+  {
+    const size_t bytes = v4_dict_seg_bytes(dict_seg_len(vm, k));
+    v4_dealloc(vm->arena, vm->dict_seg[k - 1], bytes);
+    vm->dict_seg[k - 1] = nullptr;
+  }
+  v4_dealloc(vm->arena, vm->words, v4_dict_seg_bytes(vm->dict_seg0));
+  vm->words = nullptr;
+  vm->dict_seg0 = 0;
+  vm->word_cap = 0;
+}
+
+/* Append a word; `copy` moves its bytecode into the code arena, if any. */
+static int register_word(Vm* vm, const char* name, const uint8_t* code, int code_len,
+                         bool copy)
 {
   if (!vm || !code || code_len <= 0)
     return V4_ERR(InvalidArg);
 
-  if (vm->word_count >= Vm::V4_MAX_WORDS)
+  if (vm->word_count >= vm->word_cap && !v4_dict_grow(vm))
     return vm_panic(vm, V4_ERR(DictionaryFull));
 
+  const v4_u32 code_used = vm->code_used;
+  if (copy && vm->code_size)
+  {
+    code = v4_code_copy(vm, code, code_len);
+    if (!code)
+      return vm_panic(vm, V4_ERR(NoMemory));
+  }
+
   int idx = vm->word_count;
+  Word* w = v4_dict_word(vm, idx);
+  WordName* wn = v4_word_name(w);
+  wn->hash = 0;
 
   // Copy name if provided (NULL is allowed for anonymous words)
   if (name)
   {
     size_t len = strlen(name) + 1;  // +1 for null terminator
+    wn->hash = dict_hash(name, len - 1);
 
-    // Use arena if available, otherwise malloc
+    // Use arena if available, otherwise the heap (never in V4_NO_MALLOC builds)
     if (vm->arena)
     {
       char* name_copy = static_cast<char*>(v4_arena_alloc(vm->arena, len, 1));
       if (!name_copy)
+      {
+        vm->code_used = code_used;
         return vm_panic(vm, V4_ERR(InvalidArg));  // Arena allocation failed
+      }
       memcpy(name_copy, name, len);
-      vm->words[idx].name = name_copy;
+      wn->name = name_copy;
     }
     else
     {
-      vm->words[idx].name = strdup(name);
-      if (!vm->words[idx].name)
-        return vm_panic(vm, V4_ERR(InvalidArg));  // strdup failed (out of memory)
+      char* name_copy = static_cast<char*>(v4_alloc(nullptr, len));
+      if (!name_copy)
+      {
+        vm->code_used = code_used;
+        return vm_panic(vm, V4_ERR(InvalidArg));  // out of memory
+      }
+      memcpy(name_copy, name, len);
+      wn->name = name_copy;
     }
   }
   else
   {
-    vm->words[idx].name = nullptr;
+    wn->name = nullptr;
   }
 
-  vm->words[idx].code = code;
-  vm->words[idx].code_len = code_len;
+  w->code = code;
+  w->code_len = code_len;
+
+  // A missing index only slows vm_find_word() down; it is retried on next use
+  if (name && dict_index_reserve(vm, idx + 1))
+    *dict_slot(vm, name, wn->hash) = idx;
   vm->word_count++;
 
   return idx;
 }
 
+extern "C" int vm_register_word(Vm* vm, const char* name, const uint8_t* code,
+                                int code_len)
+{
+  return register_word(vm, name, code, code_len, true);
+}
+
+extern "C" int vm_register_word_at(Vm* vm, const char* name, v4_u32 addr, int code_len)
+{
+  if (!vm || code_len <= 0)
+    return V4_ERR(InvalidArg);
+
+  const uint8_t* code = v4_mem_host_range(vm, addr, (v4_u32)code_len, V4_REGION_EXEC);
+  if (!code)
+    return V4_ERR(OobMemory);
+  return register_word(vm, name, code, code_len, false);
+}
+
 extern "C" Word* vm_get_word(Vm* vm, int idx)
 {
   if (!vm || idx < 0 || idx >= vm->word_count)
     return nullptr;
-  return &vm->words[idx];
+  return v4_dict_word(vm, idx);
 }
 
 extern "C" const char* vm_word_get_name(const Word* word)
 {
-  if (!word)
+  if (!word || !word->name_off)
     return nullptr;
-  return word->name;
+  return v4_word_name(word)->name;
 }
 
 extern "C" const v4_u8* vm_word_get_code(const Word* word)
@@ -1458,10 +1819,14 @@ extern "C" int vm_find_word(Vm* vm, const char* name)
   if (!vm || !name)
     return -1;
 
-  // Search backward to find newest definition (Forth shadowing)
+  if (vm->word_count > 0 && dict_index_reserve(vm, vm->word_count))
+    return *dict_slot(vm, name, dict_hash(name, strlen(name)));
+
+  // No index (allocation failed): search backward for the newest definition
   for (int i = vm->word_count - 1; i >= 0; i--)
   {
-    if (vm->words[i].name && strcmp(vm->words[i].name, name) == 0)
+    const char* n = v4_word_name(v4_dict_word(vm, i))->name;
+    if (n && strcmp(n, name) == 0)
     {
       return i;
     }
@@ -1477,7 +1842,15 @@ extern "C" v4_err vm_exec(Vm* vm, Word* entry)
   if (!vm || !entry || !entry->code)
     return V4_ERR(InvalidArg);
 
-  return vm_exec_raw(vm, entry->code, entry->code_len);
+  const v4_err e = vm_exec_raw(vm, entry->code, entry->code_len);
+  // Durability point for file-backed RAM; an execution error takes precedence
+  if (vm->mem_sync == V4_SYNC_AFTER_EXEC)
+  {
+    const v4_err se = v4_mem_file_sync(vm, false);
+    if (e == 0)
+      return se;
+  }
+  return e;
 }
 
 /* ======================= Stack inspection API ============================ */
@@ -1576,22 +1949,25 @@ extern "C" struct VmStackSnapshot* vm_ds_snapshot(struct Vm* vm)
   if (depth == 0)
   {
     // Empty stack - return snapshot with NULL data
-    VmStackSnapshot* snap = (VmStackSnapshot*)malloc(sizeof(VmStackSnapshot));
+    VmStackSnapshot* snap =
+        (VmStackSnapshot*)v4_alloc(vm->arena, sizeof(VmStackSnapshot));
     if (!snap)
       return nullptr;
     snap->data = nullptr;
     snap->depth = 0;
+    snap->arena = vm->arena;
     return snap;
   }
 
-  VmStackSnapshot* snap = (VmStackSnapshot*)malloc(sizeof(VmStackSnapshot));
+  VmStackSnapshot* snap = (VmStackSnapshot*)v4_alloc(vm->arena, sizeof(VmStackSnapshot));
   if (!snap)
     return nullptr;
 
-  snap->data = (v4_i32*)malloc(depth * sizeof(v4_i32));
+  snap->arena = vm->arena;
+  snap->data = (v4_i32*)v4_alloc(vm->arena, depth * sizeof(v4_i32));
   if (!snap->data)
   {
-    free(snap);
+    v4_dealloc(vm->arena, snap, sizeof(VmStackSnapshot));
     return nullptr;
   }
 
@@ -1629,7 +2005,9 @@ extern "C" void vm_ds_snapshot_free(struct VmStackSnapshot* snapshot)
   if (!snapshot)
     return;
 
+  // Data first: it sits above the header, so both come back to the arena
+  V4Arena *arena = snapshot->arena;
   if (snapshot->data)
-    free(snapshot->data);
-  free(snapshot);
+    v4_dealloc(arena, snapshot->data, sizeof(v4_i32) * (size_t)snapshot->depth);
+  v4_dealloc(arena, snapshot, sizeof(VmStackSnapshot));
 }
@@ -0,0 +1,141 @@
+// src/cow_mem.cpp — copy-on-write RAM sharing between a template VM and its forks
+#include "v4/internal/cow_mem.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "v4/errors.hpp"
+#include "v4/internal/alloc.hpp"
+#include "v4/internal/guard_mem.hpp"
+#include "v4/internal/memory.hpp"
+#include "v4/internal/paged_mem.hpp"
+
+/* Bytes of the template image: RAM plus the masked-mode tail. */
+static size_t ram_bytes(const Vm *vm)
+{
+  return (size_t)vm->mem_size + (vm->mem_mask ? V4_MEM_GUARD_BYTES : 0);
+}
+
+#ifdef V4_HAVE_COW_MAP
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+v4_err v4_cow_snapshot(Vm *tmpl)
+{
+  if (tmpl->cow_fd >= 0)
+    return V4_ERR(OK);
+
+  // Guarded RAM ends on a page boundary; capture from its first page so a
+  // fork can map the image straight over its own reservation.
+  const size_t lead = tmpl->guard_base ? (size_t)(tmpl->mem - (uint8_t *)tmpl->guard_base)
+                                       : 0;
+  const size_t len = lead + ram_bytes(tmpl);
+  const uint8_t *src = tmpl->mem - lead;
+
+  const int fd = memfd_create("v4-template", MFD_CLOEXEC);
+  if (fd < 0)
+    return V4_ERR(NoMemory);
+  void *dst = MAP_FAILED;
+  if (ftruncate(fd, (off_t)len) == 0)
+    dst = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (dst == MAP_FAILED)
+  {
+    close(fd);
+    return V4_ERR(NoMemory);
+  }
+  // A fresh memfd reads as zero: sparse templates only copy populated pages
+  if (tmpl->page_map)
+    v4_paged_copy(tmpl, (uint8_t *)dst);
+  else
+    memcpy(dst, src, len);
+  munmap(dst, len);
+
+  tmpl->cow_fd = fd;
+  tmpl->cow_lead = lead;
+  tmpl->write_watch |= V4_WATCH_COW;  // the next RAM store drops the image
+  return V4_ERR(OK);
+}
+
+v4_err v4_cow_map(Vm *child, const Vm *tmpl)
+{
+  const size_t len = tmpl->cow_lead + ram_bytes(tmpl);
+
+  if (tmpl->guard_base)
+  {
+    // Same reservation layout as the template, RAM pages replaced by the image
+    if (v4_guard_alloc(child, tmpl->mem_size) != 0)
+      return V4_ERR(NoMemory);
+    if (mmap(child->guard_base, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+             tmpl->cow_fd, 0) == MAP_FAILED)
+    {
+      v4_guard_free(child);
+      return V4_ERR(NoMemory);
+    }
+    return V4_ERR(OK);
+  }
+
+  void *p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, tmpl->cow_fd, 0);
+  if (p == MAP_FAILED)
+    return V4_ERR(NoMemory);
+  child->cow_map = p;
+  child->cow_map_len = len;
+  child->mem = (uint8_t *)p;
+  return V4_ERR(OK);
+}
+
+void v4_cow_unmap(Vm *child)
+{
+  if (!child->cow_map)
+    return;
+  munmap(child->cow_map, child->cow_map_len);
+  child->cow_map = nullptr;
+  child->cow_map_len = 0;
+  child->mem = nullptr;
+}
+
+void v4_cow_release(Vm *tmpl)
+{
+  if (tmpl->cow_fd < 0)
+    return;
+  close(tmpl->cow_fd);
+  tmpl->cow_fd = -1;
+  tmpl->write_watch &= (uint8_t)~V4_WATCH_COW;
+}
+
+#else  // !V4_HAVE_COW_MAP
+
+v4_err v4_cow_snapshot(Vm *tmpl)
+{
+  (void)tmpl;
+  return V4_ERR(OK);
+}
+
+v4_err v4_cow_map(Vm *child, const Vm *tmpl)
+{
+  // No page sharing available: each fork gets an eager private copy
+  const size_t len = ram_bytes(tmpl);
+  void *p = v4_alloc(child->arena, len);
+  if (!p)
+    return V4_ERR(NoMemory);
+  memcpy(p, tmpl->mem, len);
+  child->cow_map = p;
+  child->cow_map_len = len;
+  child->mem = (uint8_t *)p;
+  return V4_ERR(OK);
+}
+
+void v4_cow_unmap(Vm *child)
+{
+  v4_dealloc(child->arena, child->cow_map, child->cow_map_len);
+  child->cow_map = nullptr;
+  child->cow_map_len = 0;
+  child->mem = nullptr;
+}
+
+void v4_cow_release(Vm *tmpl)
+{
+  (void)tmpl;
+}
+
+#endif  // V4_HAVE_COW_MAP
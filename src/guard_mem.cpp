@@ -0,0 +1,155 @@
+// src/guard_mem.cpp — guard-page backed VM RAM with fault-driven OOB detection
+#include "v4/internal/guard_mem.hpp"
+
+#include "v4/errors.hpp"
+
+#ifdef V4_HAVE_GUARDED_MEM
+
+#include <setjmp.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* One armed v4_guard_exec() activation; frames nest per thread. */
+struct GuardFrame
+{
+  sigjmp_buf env;
+  Vm *vm;
+  GuardFrame *prev;
+};
+
+static __thread GuardFrame *tl_frame = nullptr;
+static struct sigaction g_prev_segv;
+
+static void chain_prev(int sig, siginfo_t *info, void *uctx)
+{
+  if (g_prev_segv.sa_flags & SA_SIGINFO)
+  {
+    g_prev_segv.sa_sigaction(sig, info, uctx);
+    return;
+  }
+  if (g_prev_segv.sa_handler == SIG_DFL || g_prev_segv.sa_handler == SIG_IGN)
+  {
+    // Re-executing the faulting instruction now takes the default action
+    signal(sig, SIG_DFL);
+    return;
+  }
+  g_prev_segv.sa_handler(sig);
+}
+
+static void on_segv(int sig, siginfo_t *info, void *uctx)
+{
+  const uintptr_t fault = (uintptr_t)info->si_addr;
+  for (GuardFrame *f = tl_frame; f; f = f->prev)
+  {
+    const uintptr_t base = (uintptr_t)f->vm->guard_base;
+    if (fault - base < f->vm->guard_len)
+      siglongjmp(f->env, 1);
+  }
+  chain_prev(sig, info, uctx);
+}
+
+/* (Re)install the handler unless it is already current. Hosts and test
+ * frameworks may install their own SIGSEGV handler after ours; checking on
+ * every guarded vm_create() puts ours back in front and chains to theirs. */
+static bool ensure_handler()
+{
+  struct sigaction cur;
+  if (sigaction(SIGSEGV, nullptr, &cur) != 0)
+    return false;
+  if ((cur.sa_flags & SA_SIGINFO) && cur.sa_sigaction == on_segv)
+    return true;
+
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_sigaction = on_segv;
+  // SA_NODEFER with an empty sa_mask leaves the mask untouched while the
+  // handler runs, so v4_guard_exec() need not save and restore it
+  sa.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_NODEFER;
+  sigemptyset(&sa.sa_mask);
+  return sigaction(SIGSEGV, &sa, &g_prev_segv) == 0;
+}
+
+v4_err v4_guard_alloc(Vm *vm, v4_u32 mem_size)
+{
+  if (mem_size == 0 || !ensure_handler())
+    return V4_ERR(InvalidArg);
+
+  const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  const size_t ram_pages = ((size_t)mem_size + page - 1) & ~(page - 1);
+  // Any 32-bit address plus the widest access lands inside the reservation
+  const size_t len = ram_pages + ((size_t)1 << 32) + page;
+
+  void *base = mmap(nullptr, len, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                    -1, 0);
+  if (base == MAP_FAILED)
+    return V4_ERR(NoMemory);
+  if (mprotect(base, ram_pages, PROT_READ | PROT_WRITE) != 0)
+  {
+    munmap(base, len);
+    return V4_ERR(NoMemory);
+  }
+
+  vm->guard_base = base;
+  vm->guard_len = len;
+  // End RAM on the page boundary so the first byte past mem_size faults
+  vm->mem = (uint8_t *)base + (ram_pages - mem_size);
+  vm->mem_size = mem_size;
+  return V4_ERR(OK);
+}
+
+void v4_guard_free(Vm *vm)
+{
+  if (!vm->guard_base)
+    return;
+  munmap(vm->guard_base, vm->guard_len);
+  vm->guard_base = nullptr;
+  vm->guard_len = 0;
+  vm->mem = nullptr;
+}
+
+v4_err v4_guard_exec(Vm *vm, const uint8_t *bc, int len, v4_exec_loop_fn loop)
+{
+  GuardFrame frame;
+  frame.vm = vm;
+  frame.prev = tl_frame;
+  v4_i32 *const fp = vm->fp;
+
+  if (sigsetjmp(frame.env, 0))  // no rt_sigprocmask per call, see ensure_handler()
+  {
+    // Faulted somewhere below: unwind nested CALL frames in one step
+    tl_frame = frame.prev;
+    vm->guard_frame = nullptr;
+    vm->fp = fp;
+    return V4_ERR(OobMemory);
+  }
+
+  tl_frame = &frame;
+  vm->guard_frame = &frame;
+  const v4_err e = loop(vm, bc, len);
+  tl_frame = frame.prev;
+  vm->guard_frame = nullptr;
+  return e;
+}
+
+#else  // !V4_HAVE_GUARDED_MEM
+
+v4_err v4_guard_alloc(Vm *vm, v4_u32 mem_size)
+{
+  (void)vm;
+  (void)mem_size;
+  return V4_ERR(InvalidArg);
+}
+
+void v4_guard_free(Vm *vm)
+{
+  (void)vm;
+}
+
+v4_err v4_guard_exec(Vm *vm, const uint8_t *bc, int len, v4_exec_loop_fn loop)
+{
+  return loop(vm, bc, len);
+}
+
+#endif  // V4_HAVE_GUARDED_MEM
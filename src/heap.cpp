@@ -0,0 +1,485 @@
+// src/heap.cpp — TLSF (two-level segregated fit) heap inside VM RAM
+#include <string.h>
+
+#include "v4/errors.hpp"
+#include "v4/internal/memory.hpp"
+#include "v4/internal/sys_kernels.hpp"
+#include "v4/internal/vm.h"
+#include "v4/vm_api.h"
+
+/*
+ * Everything lives in VM RAM, addressed by VM addresses, so the heap follows
+ * the VM through vm_checkpoint()/vm_rollback() and vm_fork(). Every read is
+ * bounds-checked against the heap range: bytecode that scribbles over heap
+ * metadata can make ALLOCATE fail, never touch host memory.
+ *
+ * Control block at heap_ctl:
+ *   +0 magic  +4 fl_count  +8 free_bytes  +12 fl_bitmap
+ *   +16 sl_bitmap[fl_count]  then heads[fl_count][kSlCount]
+ * Block at B (8-byte aligned):
+ *   +0 prev_phys (valid while the previous block is free)
+ *   +4 payload size | kFree | kPrevFree
+ *   +8 payload; free blocks keep next_free/prev_free in its first 8 bytes
+ * A zero-size used sentinel terminates the block chain.
+ */
+
+namespace
+{
+const v4_u32 kMagic = 0x464C5354u;  // "TLSF"
+const v4_u32 kAlignLog2 = 3;
+const v4_u32 kAlign = 1u << kAlignLog2;
+const v4_u32 kSlLog2 = 4;
+const v4_u32 kSlCount = 1u << kSlLog2;
+const v4_u32 kFlShift = kSlLog2 + kAlignLog2;  // sizes below 128 share fl 0
+const v4_u32 kSmall = 1u << kFlShift;
+const v4_u32 kHdr = 8;      // block header
+const v4_u32 kMinBlock = 8; // payload room for the free-list links
+const v4_u32 kFree = 1u;
+const v4_u32 kPrevFree = 2u;
+const v4_u32 kSizeMask = ~(kAlign - 1);
+
+inline v4_u32 fls32(v4_u32 x)  // index of the highest set bit, x != 0
+{
+  return (v4_u32)v4_fls32(x);
+}
+
+inline v4_u32 ffs32(v4_u32 x)  // index of the lowest set bit, x != 0
+{
+  return (v4_u32)v4_ffs32(x);
+}
+
+inline v4_u32 align_up(v4_u32 x)
+{
+  return (x + kAlign - 1) & kSizeMask;
+}
+
+/* One heap operation; `bad` latches on any out-of-range metadata access. */
+struct Heap
+{
+  Vm *vm;
+  v4_u32 lo;  // heap_ctl
+  v4_u32 hi;  // heap_ctl + heap_size
+  v4_u32 fl_count;
+  bool bad;
+
+  explicit Heap(Vm *v) : vm(v), lo(v->heap_ctl), hi(v->heap_ctl + v->heap_size), bad(false)
+  {
+    fl_count = v->heap_size ? get(lo + 4) : 0;
+    if (get(lo) != kMagic || fl_count == 0 || fl_count > 32)
+      bad = true;
+  }
+
+  v4_u32 get(v4_u32 a)
+  {
+    if (a < lo || a > hi - 4 || bad)
+    {
+      bad = true;
+      return 0;
+    }
+    const uint8_t *p = vm->mem + a;
+    return (v4_u32)p[0] | ((v4_u32)p[1] << 8) | ((v4_u32)p[2] << 16) | ((v4_u32)p[3] << 24);
+  }
+
+  void put(v4_u32 a, v4_u32 v)
+  {
+    if (a < lo || a > hi - 4 || bad)
+    {
+      bad = true;
+      return;
+    }
+    v4_mem_note_write(vm, a, 4);
+    uint8_t *p = vm->mem + a;
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+  }
+
+  /* Control block fields */
+  v4_u32 sl_addr(v4_u32 fl) { return lo + 16 + 4 * fl; }
+  v4_u32 head_addr(v4_u32 fl, v4_u32 sl)
+  {
+    return lo + 16 + 4 * fl_count + 4 * (fl * kSlCount + sl);
+  }
+  v4_u32 first_block() { return align_up(head_addr(fl_count, 0)); }
+
+  /* Block fields */
+  v4_u32 size(v4_u32 b) { return get(b + 4) & kSizeMask; }
+  v4_u32 flags(v4_u32 b) { return get(b + 4) & (kAlign - 1); }
+  void set_size_flags(v4_u32 b, v4_u32 sz, v4_u32 fl) { put(b + 4, sz | fl); }
+  void set_flag(v4_u32 b, v4_u32 f, bool on)
+  {
+    const v4_u32 w = get(b + 4);
+    put(b + 4, on ? (w | f) : (w & ~f));
+  }
+  v4_u32 next_phys(v4_u32 b) { return b + kHdr + size(b); }
+
+  /* Size -> (fl, sl) list indices */
+  static void mapping(v4_u32 sz, v4_u32 *fl, v4_u32 *sl)
+  {
+    if (sz < kSmall)
+    {
+      *fl = 0;
+      *sl = sz >> kAlignLog2;
+      return;
+    }
+    const v4_u32 f = fls32(sz);
+    *sl = (sz >> (f - kSlLog2)) ^ kSlCount;
+    *fl = f - (kFlShift - 1);
+  }
+
+  void insert_free(v4_u32 b)
+  {
+    const v4_u32 sz = size(b);
+    v4_u32 fl, sl;
+    mapping(sz, &fl, &sl);
+    if (fl >= fl_count)
+    {
+      bad = true;
+      return;
+    }
+    const v4_u32 head = get(head_addr(fl, sl));
+    put(b + 8, head);
+    put(b + 12, 0);
+    if (head)
+      put(head + 12, b);
+    put(head_addr(fl, sl), b);
+    put(lo + 12, get(lo + 12) | (1u << fl));
+    put(sl_addr(fl), get(sl_addr(fl)) | (1u << sl));
+    set_flag(b, kFree, true);
+    put(lo + 8, get(lo + 8) + sz);
+  }
+
+  void remove_free(v4_u32 b)
+  {
+    const v4_u32 sz = size(b);
+    v4_u32 fl, sl;
+    mapping(sz, &fl, &sl);
+    if (fl >= fl_count)
+    {
+      bad = true;
+      return;
+    }
+    const v4_u32 next = get(b + 8);
+    const v4_u32 prev = get(b + 12);
+    if (next)
+      put(next + 12, prev);
+    if (prev)
+      put(prev + 8, next);
+    else
+    {
+      put(head_addr(fl, sl), next);
+      if (!next)
+      {
+        const v4_u32 slm = get(sl_addr(fl)) & ~(1u << sl);
+        put(sl_addr(fl), slm);
+        if (!slm)
+          put(lo + 12, get(lo + 12) & ~(1u << fl));
+      }
+    }
+    set_flag(b, kFree, false);
+    put(lo + 8, get(lo + 8) - sz);
+  }
+
+  /* First non-empty list whose blocks all fit sz (good fit, O(1)). */
+  v4_u32 find_suitable(v4_u32 sz)
+  {
+    if (sz >= kSmall)
+    {
+      const v4_u32 round = (1u << (fls32(sz) - kSlLog2)) - 1;
+      if (sz > 0xFFFFFFFFu - round)
+        return 0;
+      sz += round;
+    }
+    v4_u32 fl, sl;
+    mapping(sz, &fl, &sl);
+    if (fl >= fl_count)
+      return 0;
+    v4_u32 sl_map = get(sl_addr(fl)) & (~0u << sl);
+    if (!sl_map)
+    {
+      const v4_u32 fl_map = fl + 1 < 32 ? get(lo + 12) & (~0u << (fl + 1)) : 0;
+      if (!fl_map)
+        return 0;
+      fl = ffs32(fl_map);
+      if (fl >= fl_count)
+        return 0;
+      sl_map = get(sl_addr(fl));
+      if (!sl_map)
+      {
+        bad = true;
+        return 0;
+      }
+    }
+    return get(head_addr(fl, ffs32(sl_map)));
+  }
+
+  /* Turn the tail of used block b beyond sz into a free block. */
+  void trim(v4_u32 b, v4_u32 sz)
+  {
+    const v4_u32 cur = size(b);
+    if (cur < sz + kHdr + kMinBlock)
+      return;
+    const v4_u32 rem = b + kHdr + sz;
+    set_size_flags(b, sz, flags(b));
+    set_size_flags(rem, cur - sz - kHdr, 0);
+    absorb_next(rem);
+    insert_free(rem);
+    link_next(rem, true);
+  }
+
+  /* Merge free next neighbour into b (b not on a free list). */
+  void absorb_next(v4_u32 b)
+  {
+    const v4_u32 n = next_phys(b);
+    if (!bad && (flags(n) & kFree))
+    {
+      remove_free(n);
+      set_size_flags(b, size(b) + kHdr + size(n), flags(b));
+    }
+  }
+
+  /* Tell the physical successor whether b is free. */
+  void link_next(v4_u32 b, bool free)
+  {
+    const v4_u32 n = next_phys(b);
+    if (free)
+      put(n, b);
+    set_flag(n, kPrevFree, free);
+  }
+
+  /* Validate a payload address handed back by bytecode; returns its block. */
+  v4_u32 used_block(v4_u32 a)
+  {
+    const v4_u32 b = a - kHdr;
+    if (a < first_block() + kHdr || a >= hi || (a & (kAlign - 1)))
+      return 0;
+    const v4_u32 w = get(b + 4);
+    if (bad || (w & kFree) || (w & kSizeMask) == 0 ||
+        (uint64_t)b + kHdr + (w & kSizeMask) + kHdr > hi)
+      return 0;
+    return b;
+  }
+
+  v4_u32 alloc(v4_u32 n)
+  {
+    if (n == 0 || n > hi - lo)
+      return 0;
+    const v4_u32 sz = align_up(n) < kMinBlock ? kMinBlock : align_up(n);
+    const v4_u32 b = find_suitable(sz);
+    if (!b)
+      return 0;
+    remove_free(b);
+    link_next(b, false);
+    trim(b, sz);
+    return bad ? 0 : b + kHdr;
+  }
+
+  void release(v4_u32 b)
+  {
+    if (flags(b) & kPrevFree)
+    {
+      const v4_u32 p = get(b);
+      if (p < first_block() || p >= b || !(flags(p) & kFree) || next_phys(p) != b)
+      {
+        bad = true;
+        return;
+      }
+      // Leave the stale header marked free so a second FREE is caught
+      set_flag(b, kFree, true);
+      remove_free(p);
+      set_size_flags(p, size(p) + kHdr + size(b), flags(p));
+      b = p;
+    }
+    absorb_next(b);
+    insert_free(b);
+    link_next(b, true);
+  }
+};
+}  // namespace
+
+/* ------------------------------------------------------------------------- */
+/* Host API                                                                  */
+/* ------------------------------------------------------------------------- */
+
+extern "C" v4_err vm_heap_init(struct Vm *vm, v4_u32 addr, v4_u32 size)
+{
+  if (!vm)
+    return V4_ERR(InvalidArg);
+  vm->heap_ctl = 0;
+  vm->heap_size = 0;
+  if (size == 0)
+    return V4_ERR(OK);  // heap disabled
+
+  const v4_u32 lo = align_up(addr);
+  if (lo < addr || v4_ram_range(vm, addr, size) == nullptr || size < lo - addr)
+    return V4_ERR(InvalidArg);
+  const v4_u32 hi = (addr + size) & kSizeMask;
+  if (hi <= lo)
+    return V4_ERR(InvalidArg);
+
+  // Size the first level for the largest possible block
+  const v4_u32 span = hi - lo;
+  const v4_u32 fl_count = span >= kSmall ? fls32(span) - (kFlShift - 1) + 1 : 1;
+  vm->heap_ctl = lo;
+  vm->heap_size = span;
+
+  Heap h(vm);
+  h.bad = false;
+  h.fl_count = fl_count;
+  const v4_u32 first = h.first_block();
+  if ((uint64_t)first + 2 * kHdr + kMinBlock > hi)
+  {
+    vm->heap_ctl = 0;
+    vm->heap_size = 0;
+    return V4_ERR(InvalidArg);
+  }
+
+  h.put(lo, kMagic);
+  h.put(lo + 4, fl_count);
+  for (v4_u32 a = lo + 8; a < first; a += 4)
+    h.put(a, 0);
+
+  // One free block spanning everything up to the sentinel
+  const v4_u32 sentinel = hi - kHdr;
+  h.set_size_flags(first, sentinel - first - kHdr, 0);
+  h.set_size_flags(sentinel, 0, 0);
+  h.insert_free(first);
+  h.link_next(first, true);
+  return h.bad ? V4_ERR(InvalidArg) : V4_ERR(OK);
+}
+
+extern "C" v4_err vm_heap_stats(struct Vm *vm, V4HeapStats *out)
+{
+  if (!vm || !out)
+    return V4_ERR(InvalidArg);
+  memset(out, 0, sizeof(*out));
+  if (!vm->heap_size)
+    return V4_ERR(OK);
+
+  Heap h(vm);
+  out->size = vm->heap_size;
+  out->free_bytes = h.get(h.lo + 8);
+  const v4_u32 fl_map = h.get(h.lo + 12);
+  if (fl_map)
+  {
+    // Largest block lives in the highest non-empty list; walk just that one
+    const v4_u32 fl = fls32(fl_map);
+    const v4_u32 sl_map = fl < h.fl_count ? h.get(h.sl_addr(fl)) : 0;
+    v4_u32 b = sl_map ? h.get(h.head_addr(fl, fls32(sl_map))) : 0;
+    for (v4_u32 guard = vm->heap_size / (kHdr + kMinBlock); b && guard && !h.bad; --guard)
+    {
+      if (h.size(b) > out->largest_free)
+        out->largest_free = h.size(b);
+      b = h.get(b + 8);
+    }
+  }
+  if (out->free_bytes)
+    out->fragmentation =
+        100u - (v4_u32)((uint64_t)out->largest_free * 100u / out->free_bytes);
+  return h.bad ? V4_ERR(InvalidArg) : V4_ERR(OK);
+}
+
+/* ------------------------------------------------------------------------- */
+/* SYS kernels                                                               */
+/* ------------------------------------------------------------------------- */
+
+/* ( u -- addr ior ) */
+v4_err v4_k_allocate(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  out[0] = 0;
+  if (!vm->heap_size)
+  {
+    out[1] = V4_ERR(InvalidArg);
+    return V4_ERR(OK);
+  }
+  Heap h(vm);
+  const v4_u32 a = h.bad ? 0 : h.alloc((v4_u32)in[0]);
+  out[0] = (v4_i32)a;
+  out[1] = a ? V4_ERR(OK) : V4_ERR(NoMemory);
+  return V4_ERR(OK);
+}
+
+/* ( addr -- ior ) */
+v4_err v4_k_free(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  if (!vm->heap_size)
+  {
+    out[0] = V4_ERR(InvalidArg);
+    return V4_ERR(OK);
+  }
+  Heap h(vm);
+  const v4_u32 b = h.bad ? 0 : h.used_block((v4_u32)in[0]);
+  if (b)
+    h.release(b);
+  out[0] = (b && !h.bad) ? V4_ERR(OK) : V4_ERR(InvalidArg);
+  return V4_ERR(OK);
+}
+
+/* ( addr u -- addr' ior ) */
+v4_err v4_k_resize(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  const v4_u32 a = (v4_u32)in[0];
+  const v4_u32 n = (v4_u32)in[1];
+  out[0] = (v4_i32)a;
+  if (a == 0)
+    return v4_k_allocate(vm, &in[1], out);
+  if (!vm->heap_size)
+  {
+    out[1] = V4_ERR(InvalidArg);
+    return V4_ERR(OK);
+  }
+
+  Heap h(vm);
+  const v4_u32 b = h.bad ? 0 : h.used_block(a);
+  if (!b || n > h.hi - h.lo)
+  {
+    out[1] = b ? V4_ERR(NoMemory) : V4_ERR(InvalidArg);
+    return V4_ERR(OK);
+  }
+  const v4_u32 sz = align_up(n) < kMinBlock ? kMinBlock : align_up(n);
+  const v4_u32 cur = h.size(b);
+
+  // Grow in place into a free successor
+  if (sz > cur)
+  {
+    const v4_u32 nx = h.next_phys(b);
+    if ((h.flags(nx) & kFree) && cur + kHdr + h.size(nx) >= sz)
+    {
+      h.absorb_next(b);
+      h.link_next(b, false);
+    }
+  }
+  if (h.size(b) >= sz)
+  {
+    h.trim(b, sz);
+    out[1] = h.bad ? V4_ERR(InvalidArg) : V4_ERR(OK);
+    return V4_ERR(OK);
+  }
+
+  // Move: the original block stays valid if there is no room
+  const v4_u32 na = h.alloc(n);
+  if (!na)
+  {
+    out[1] = h.bad ? V4_ERR(InvalidArg) : V4_ERR(NoMemory);
+    return V4_ERR(OK);
+  }
+  v4_mem_note_write(vm, na, cur);
+  memmove(vm->mem + na, vm->mem + a, cur);
+  h.release(b);
+  out[0] = (v4_i32)na;
+  out[1] = h.bad ? V4_ERR(InvalidArg) : V4_ERR(OK);
+  return V4_ERR(OK);
+}
+
+/* ( -- free largest frag% ) */
+v4_err v4_k_heap_stats(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  (void)in;
+  V4HeapStats st;
+  vm_heap_stats(vm, &st);
+  out[0] = (v4_i32)st.free_bytes;
+  out[1] = (v4_i32)st.largest_free;
+  out[2] = (v4_i32)st.fragmentation;
+  return V4_ERR(OK);
+}
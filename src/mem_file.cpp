@@ -0,0 +1,83 @@
+// src/mem_file.cpp — file-backed persistent VM RAM via mmap
+#include "v4/internal/mem_file.hpp"
+
+#include "v4/errors.hpp"
+
+#ifdef V4_HAVE_MEM_FILE
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+v4_err v4_mem_file_map(Vm *vm, const char *path, size_t map_len)
+{
+  if (!path || map_len == 0)
+    return V4_ERR(InvalidArg);
+
+  const int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0)
+    return V4_ERR(IoError);
+
+  // Grow (sparsely) but never shrink: a larger file keeps its tail
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      ((size_t)st.st_size < map_len && ftruncate(fd, (off_t)map_len) != 0))
+  {
+    close(fd);
+    return V4_ERR(IoError);
+  }
+
+  void *p = mmap(nullptr, map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);  // the mapping keeps the file referenced
+  if (p == MAP_FAILED)
+    return V4_ERR(NoMemory);
+
+  vm->mem_map = p;
+  vm->mem_map_len = map_len;
+  vm->mem = (uint8_t *)p;
+  return V4_ERR(OK);
+}
+
+v4_err v4_mem_file_sync(Vm *vm, bool wait)
+{
+  if (!vm->mem_map)
+    return V4_ERR(OK);
+  return msync(vm->mem_map, vm->mem_map_len, wait ? MS_SYNC : MS_ASYNC) == 0
+             ? V4_ERR(OK)
+             : V4_ERR(IoError);
+}
+
+void v4_mem_file_unmap(Vm *vm)
+{
+  if (!vm->mem_map)
+    return;
+  munmap(vm->mem_map, vm->mem_map_len);
+  vm->mem_map = nullptr;
+  vm->mem_map_len = 0;
+  vm->mem = nullptr;
+}
+
+#else  // !V4_HAVE_MEM_FILE
+
+v4_err v4_mem_file_map(Vm *vm, const char *path, size_t map_len)
+{
+  (void)vm;
+  (void)path;
+  (void)map_len;
+  return V4_ERR(InvalidArg);
+}
+
+v4_err v4_mem_file_sync(Vm *vm, bool wait)
+{
+  (void)vm;
+  (void)wait;
+  return V4_ERR(OK);
+}
+
+void v4_mem_file_unmap(Vm *vm)
+{
+  (void)vm;
+}
+
+#endif  // V4_HAVE_MEM_FILE
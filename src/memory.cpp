@@ -5,6 +5,12 @@
 #include <string.h>
 
 #include "v4/errors.hpp"
+#include "v4/internal/alloc.hpp"
+#include "v4/internal/code_arena.hpp"
+#include "v4/internal/cow_mem.hpp"
+#include "v4/internal/guard_mem.hpp"
+#include "v4/internal/mem_file.hpp"
+#include "v4/internal/paged_mem.hpp"
 #include "v4/internal/vm.h"  // internal Vm definition (your repo)
 #include "v4/vm_api.h"
 
@@ -30,35 +36,292 @@ static inline void st_le16(uint8_t *p, uint16_t v)
   p[1] = (uint8_t)((v >> 8) & 0xFF);
 }
 
-/* ---- MMIO window lookup (linear) ---- */
-static int find_mmio(Vm *vm, v4_u32 addr)
+/* ---- Address decode (MMIO windows + extra memory regions) ---- */
+
+/* Shadow bit or hull test + binary search. A RAM page no range touches, or an
+ * address above RAM outside [decode_lo, decode_lo + decode_hull], goes
+ * straight to RAM without touching the table. */
+static inline const VmDecodeRange *decode_lookup(const Vm *vm, v4_u32 addr)
+{
+  if (vm->decode_count == 0)
+    return nullptr;
+  const v4_u32 page = addr >> V4_DECODE_PAGE_SHIFT;
+  if (page < vm->decode_pages)
+  {
+    if (!vm->decode_shadow || !((vm->decode_shadow[page >> 5] >> (page & 31)) & 1u))
+      return nullptr;
+  }
+  else if ((addr - vm->decode_lo) > vm->decode_hull)
+    return nullptr;
+  const VmDecodeRange *r = vm->decode;
+  int lo = 0;
+  int hi = vm->decode_count - 1;
+  while (lo <= hi)
+  {
+    const int mid = (lo + hi) / 2;
+    if (addr < r[mid].lo)
+      hi = mid - 1;
+    else if (addr > r[mid].last)
+      lo = mid + 1;
+    else
+      return &r[mid];
+  }
+  return nullptr;
+}
+
+/* Host pointer for a bytes-wide access to a host-memory entry, or NULL if the
+ * access leaves the entry or the entry lacks the required attributes. */
+static inline uint8_t *host_ptr(const VmDecodeRange *d, v4_u32 addr, v4_u32 bytes,
+                                v4_u32 need)
 {
-  for (int i = 0; i < vm->mmio_count; ++i)
+  const v4_u32 off = addr - d->lo;
+  if ((d->flags & need) != need || (uint64_t)off + bytes > (uint64_t)(d->last - d->lo) + 1)
+    return nullptr;
+  return d->data + off;  // writes are gated by V4_REGION_WRITE
+}
+
+/* Decode targets in priority order: MMIO windows first, then regions. */
+static void target_span(const Vm *vm, int t, v4_u32 *base, v4_u32 *size)
+{
+  if (t < vm->mmio_count)
+  {
+    *base = vm->mmio[t].base;
+    *size = vm->mmio[t].size;
+  }
+  else
+  {
+    *base = vm->regions[t - vm->mmio_count].base;
+    *size = vm->regions[t - vm->mmio_count].size;
+  }
+}
+
+/*
+ * Rebuild the decode table from vm->mmio and vm->regions. Target edges split
+ * the address space into elementary segments; each segment is owned by the
+ * first target (MMIO in registration order, then regions) that covers it,
+ * and equal neighbours are merged. Runs only at registration time, so
+ * O(n^2) is fine.
+ */
+static v4_err decode_rebuild(Vm *vm)
+{
+  const int n = vm->mmio_count + vm->region_count;
+  const size_t pts_bytes = sizeof(uint64_t) * 2 * (size_t)n;
+  const size_t out_bytes = n ? sizeof(VmDecodeRange) * (2 * (size_t)n - 1) : 0;
+  uint64_t *pts = nullptr;
+  VmDecodeRange *out = nullptr;
+  int np = 0;
+  int nr = 0;
+
+  if (n > 0)
+  {
+    // n targets make at most 2n - 1 segments. The table is allocated before
+    // the scratch edge list so that the scratch is the one released first.
+    out = (VmDecodeRange *)v4_alloc(vm->arena, out_bytes);
+    pts = (uint64_t *)v4_alloc(vm->arena, pts_bytes);
+    if (!out || !pts)
+    {
+      v4_dealloc(vm->arena, pts, pts_bytes);
+      v4_dealloc(vm->arena, out, out_bytes);
+      return V4_ERR(NoMemory);
+    }
+    for (int t = 0; t < n; ++t)
+    {
+      v4_u32 base, size;
+      target_span(vm, t, &base, &size);
+      if (size == 0)
+        continue;
+      pts[np++] = base;
+      pts[np++] = (uint64_t)base + size;
+    }
+  }
+
+  if (np > 0)
+  {
+    // Insertion sort: a handful of edges, and no libc sort that may allocate
+    for (int i = 1; i < np; ++i)
+    {
+      const uint64_t v = pts[i];
+      int j = i;
+      for (; j > 0 && pts[j - 1] > v; --j)
+        pts[j] = pts[j - 1];
+      pts[j] = v;
+    }
+    int u = 1;
+    for (int i = 1; i < np; ++i)
+      if (pts[i] != pts[u - 1])
+        pts[u++] = pts[i];
+    np = u;
+
+    for (int i = 0; i + 1 < np; ++i)
+    {
+      const v4_u32 lo = (v4_u32)pts[i];
+      const v4_u32 last = (v4_u32)(pts[i + 1] - 1);
+      int owner = -1;
+      for (int t = 0; t < n; ++t)
+      {
+        v4_u32 base, size;
+        target_span(vm, t, &base, &size);
+        if (lo >= base && (lo - base) < size)
+        {
+          owner = t;
+          break;
+        }
+      }
+      if (owner < 0)
+        continue;
+      VmDecodeRange seg{lo, last, V4_DECODE_MMIO, 0, owner, nullptr};
+      if (owner < vm->mmio_count)
+      {
+        const V4_Mmio *m = &vm->mmio[owner];
+        if (m->data)
+        {
+          seg.kind = V4_DECODE_HOST;
+          seg.flags = (uint8_t)(m->flags & (V4_REGION_READ | V4_REGION_WRITE));
+          seg.data = m->data + (lo - m->base);
+        }
+      }
+      else
+      {
+        const V4_Region *r = &vm->regions[owner - vm->mmio_count];
+        seg.kind = V4_DECODE_HOST;
+        seg.flags = (uint8_t)r->flags;
+        seg.data = (uint8_t *)r->data + (lo - r->base);
+      }
+      VmDecodeRange *prev = nr ? &out[nr - 1] : nullptr;
+      if (prev && prev->kind == seg.kind && prev->index == seg.index &&
+          (uint64_t)prev->last + 1 == lo)
+        prev->last = last;
+      else
+        out[nr++] = seg;
+    }
+  }
+  v4_dealloc(vm->arena, pts, pts_bytes);
+
+  // Whole RAM pages are split off the hull: one bit each says whether any
+  // range lies on the page, so windows on both sides of a RAM address never
+  // send it through the search.
+  const v4_u32 pages = vm->mem ? vm->mem_size >> V4_DECODE_PAGE_SHIFT : 0;
+  const uint64_t ram_end = (uint64_t)pages << V4_DECODE_PAGE_SHIFT;
+  const size_t shadow_bytes = sizeof(uint32_t) * (((size_t)pages + 31) / 32);
+  uint32_t *shadow = nullptr;
+  if (nr > 0 && out[0].lo < ram_end)
+  {
+    shadow = (uint32_t *)v4_alloc(vm->arena, shadow_bytes);
+    if (!shadow)
+    {
+      v4_dealloc(vm->arena, out, out_bytes);
+      return V4_ERR(NoMemory);
+    }
+    ::memset(shadow, 0, shadow_bytes);
+    for (int i = 0; i < nr && out[i].lo < ram_end; ++i)
+    {
+      const v4_u32 first = out[i].lo >> V4_DECODE_PAGE_SHIFT;
+      const v4_u32 last = (v4_u32)(out[i].last < ram_end ? out[i].last : ram_end - 1) >>
+                          V4_DECODE_PAGE_SHIFT;
+      for (v4_u32 p = first; p <= last; ++p)
+        shadow[p >> 5] |= 1u << (p & 31);
+    }
+  }
+  int above = 0;
+  while (above < nr && out[above].last < ram_end)
+    above++;
+
+  v4_dealloc(vm->arena, vm->decode_shadow,
+             sizeof(uint32_t) * (((size_t)vm->decode_pages + 31) / 32));
+  v4_dealloc(vm->arena, vm->decode, sizeof(VmDecodeRange) * (size_t)vm->decode_cap);
+  vm->decode = out;
+  vm->decode_count = nr;
+  vm->decode_cap = n ? 2 * n - 1 : 0;
+  vm->decode_pages = pages;
+  vm->decode_shadow = shadow;
+  vm->decode_lo = 0;
+  vm->decode_hull = 0;
+  if (above < nr)
   {
-    const v4_u32 base = vm->mmio[i].base;
-    const v4_u32 size = vm->mmio[i].size;
-    if (addr >= base && (addr - base) < size)
-      return i;
+    vm->decode_lo = out[above].lo < ram_end ? (v4_u32)ram_end : out[above].lo;
+    vm->decode_hull = out[nr - 1].last - vm->decode_lo;
   }
-  return -1;
+  return 0;
+}
+
+/* ---- Write watch ---- */
+void v4_mem_watch_write(Vm *vm, v4_u32 addr, v4_u32 len)
+{
+  // The fork image no longer matches RAM: drop it so the next vm_fork()
+  // captures a fresh one. Forks made so far keep the image they mapped.
+  if (vm->write_watch & V4_WATCH_COW)
+    v4_cow_release(vm);
+  if (vm->write_watch & V4_WATCH_CKPT)
+    v4_ckpt_touch(vm, addr, len);
 }
 
+/* ---- Host pointer resolution for whole ranges ---- */
+uint8_t *v4_mem_host_range(Vm *vm, v4_u32 addr, v4_u32 len, v4_u32 need)
+{
+  if (len == 0)
+    return nullptr;
+  if (const VmDecodeRange *d = decode_lookup(vm, addr))
+    return d->kind == V4_DECODE_HOST ? host_ptr(d, addr, len, need) : nullptr;
+  return v4_ram_range(vm, addr, len);  // primary RAM is read/write/execute
+}
+
+/* ---- Guarded RAM: unchecked host-order access (memcpy = one load/store) ---- */
+#ifdef V4_HAVE_GUARDED_MEM
+static inline v4_err guarded_misaligned(Vm *vm, v4_u32 addr)
+{
+  // Keep the checked-mode precedence: OOB wins over Unaligned
+  return v4_is_in_ram(vm, addr, 4) ? V4_ERR(OobMemory) : V4_ERR(Unaligned);
+}
+#endif
+
 /* ---- core 32-bit accessors (used by VM ops and public API) ---- */
+template <V4MemPath P>
 v4_err v4_mem_read32_core(Vm *vm, v4_u32 addr, v4_u32 *out)
 {
-  // 1) MMIO window?
-  const int mi = find_mmio(vm, addr);
-  if (mi >= 0)
+  // 1) MMIO window or host memory? (hull test keeps plain RAM off the table)
+  if (const VmDecodeRange *d = decode_lookup(vm, addr))
   {
     // (Option) For MMIO we can keep alignment check; but OOB must not shadow it.
     if (int e = v4_is_aligned4(addr))
       return e;
-    const V4_Mmio *m = &vm->mmio[mi];
+    if (d->kind == V4_DECODE_HOST)
+    {
+      const uint8_t *p = host_ptr(d, addr, 4, V4_REGION_READ);
+      if (!p)
+        return V4_ERR(OobMemory);
+      if (d->flags & V4_REGION_SHARED)
+        *out = v4_le_to_host(__atomic_load_n((const v4_u32 *)(const void *)p,
+                                             __ATOMIC_RELAXED));
+      else
+        *out = ld_le32(p);
+      return 0;
+    }
+    const V4_Mmio *m = &vm->mmio[d->index];
     if (!m->read32)
       return V4_ERR(OobMemory);  // forbidden -> treat as OOB
     return m->read32(m->user, addr, out);
   }
 
+  // Masked sandbox: wrap instead of range check
+  if constexpr (P == V4_MEM_PATH_MASKED)
+  {
+    if (int e = v4_is_aligned4(addr))
+      return e;
+    *out = ld_le32(&vm->mem[addr & vm->mem_mask]);
+    return 0;
+  }
+
+#ifdef V4_HAVE_GUARDED_MEM
+  // Guard pages: out-of-range access faults and unwinds to v4_guard_exec()
+  if constexpr (P == V4_MEM_PATH_GUARDED)
+  {
+    if (addr & 3u)
+      return guarded_misaligned(vm, addr);
+    memcpy(out, &vm->mem[addr], 4);
+    return 0;
+  }
+#endif
+
   // 2) RAM range check FIRST (so OOB wins over Unaligned)
   if (int e = v4_is_in_ram(vm, addr, 4))
     return e;
@@ -72,20 +335,52 @@ v4_err v4_mem_read32_core(Vm *vm, v4_u32 addr, v4_u32 *out)
   return 0;
 }
 
+template <V4MemPath P>
 v4_err v4_mem_write32_core(Vm *vm, v4_u32 addr, v4_u32 val)
 {
-  // 1) MMIO window?
-  const int mi = find_mmio(vm, addr);
-  if (mi >= 0)
+  // 1) MMIO window or host memory?
+  if (const VmDecodeRange *d = decode_lookup(vm, addr))
   {
     if (int e = v4_is_aligned4(addr))
       return e;
-    const V4_Mmio *m = &vm->mmio[mi];
+    if (d->kind == V4_DECODE_HOST)
+    {
+      uint8_t *p = host_ptr(d, addr, 4, V4_REGION_WRITE);
+      if (!p)
+        return V4_ERR(OobMemory);  // read-only or crossing the region end
+      if (d->flags & V4_REGION_SHARED)
+        __atomic_store_n((v4_u32 *)(void *)p, v4_le_to_host(val), __ATOMIC_RELAXED);
+      else
+        st_le32(p, val);
+      return 0;
+    }
+    const V4_Mmio *m = &vm->mmio[d->index];
     if (!m->write32)
       return V4_ERR(OobMemory);  // forbidden
     return m->write32(m->user, addr, val);
   }
 
+  // Masked sandbox: wrap instead of range check
+  if constexpr (P == V4_MEM_PATH_MASKED)
+  {
+    if (int e = v4_is_aligned4(addr))
+      return e;
+    v4_mem_note_write(vm, addr & vm->mem_mask, 4);
+    st_le32(&vm->mem[addr & vm->mem_mask], val);
+    return 0;
+  }
+
+#ifdef V4_HAVE_GUARDED_MEM
+  if constexpr (P == V4_MEM_PATH_GUARDED)
+  {
+    if (addr & 3u)
+      return guarded_misaligned(vm, addr);
+    v4_mem_note_write(vm, addr, 4);
+    memcpy(&vm->mem[addr], &val, 4);
+    return 0;
+  }
+#endif
+
   // 2) RAM range check FIRST
   if (int e = v4_is_in_ram(vm, addr, 4))
     return e;
@@ -95,14 +390,136 @@ v4_err v4_mem_write32_core(Vm *vm, v4_u32 addr, v4_u32 val)
     return e;
 
   // 4) Store
+  v4_mem_note_write(vm, addr, 4);
   st_le32(&vm->mem[addr], val);
   return 0;
 }
 
+/* ---- atomic 32-bit cell operations (ALOAD/ASTORE/CAS/AADD) ---- */
+
+/*
+ * Resolve an aligned cell in host memory (RAM, region or direct window) for
+ * an atomic access. Same precedence as plain LOAD/STORE (OOB before
+ * Unaligned); callback MMIO windows have no atomic access. The host address
+ * must also be 4-byte aligned, otherwise the access could not be atomic.
+ */
+static v4_err atomic_cell(Vm *vm, v4_u32 addr, v4_u32 need, v4_u32 **cell)
+{
+  uint8_t *p;
+  if (const VmDecodeRange *d = decode_lookup(vm, addr))
+  {
+    if (d->kind != V4_DECODE_HOST)
+      return V4_ERR(OobMemory);
+    if (int e = v4_is_aligned4(addr))
+      return e;
+    p = host_ptr(d, addr, 4, need);
+    if (!p)
+      return V4_ERR(OobMemory);
+  }
+  else
+  {
+    if (vm->mem_mask)
+      addr &= vm->mem_mask;
+    if (int e = v4_is_in_ram(vm, addr, 4))
+      return e;
+    if (int e = v4_is_aligned4(addr))
+      return e;
+    p = vm->mem + addr;
+    if (need & V4_REGION_WRITE)
+      v4_mem_note_write(vm, addr, 4);
+  }
+  if ((uintptr_t)p & 3u)
+    return V4_ERR(Unaligned);
+  *cell = (v4_u32 *)(void *)p;
+  return 0;
+}
+
+v4_err v4_mem_aload32(Vm *vm, v4_u32 addr, v4_u32 *out)
+{
+  v4_u32 *c;
+  if (v4_err e = atomic_cell(vm, addr, V4_REGION_READ, &c))
+    return e;
+  *out = v4_le_to_host(__atomic_load_n(c, __ATOMIC_ACQUIRE));
+  return 0;
+}
+
+v4_err v4_mem_astore32(Vm *vm, v4_u32 addr, v4_u32 val)
+{
+  v4_u32 *c;
+  if (v4_err e = atomic_cell(vm, addr, V4_REGION_WRITE, &c))
+    return e;
+  __atomic_store_n(c, v4_le_to_host(val), __ATOMIC_RELEASE);
+  return 0;
+}
+
+v4_err v4_mem_cas32(Vm *vm, v4_u32 addr, v4_u32 expected, v4_u32 desired, v4_u32 *old)
+{
+  v4_u32 *c;
+  if (v4_err e = atomic_cell(vm, addr, V4_REGION_READ | V4_REGION_WRITE, &c))
+    return e;
+  v4_u32 cur = v4_le_to_host(expected);
+  __atomic_compare_exchange_n(c, &cur, v4_le_to_host(desired), false, __ATOMIC_SEQ_CST,
+                              __ATOMIC_SEQ_CST);
+  *old = v4_le_to_host(cur);
+  return 0;
+}
+
+v4_err v4_mem_aadd32(Vm *vm, v4_u32 addr, v4_u32 n, v4_u32 *old)
+{
+  v4_u32 *c;
+  if (v4_err e = atomic_cell(vm, addr, V4_REGION_READ | V4_REGION_WRITE, &c))
+    return e;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v4_u32 cur = __atomic_load_n(c, __ATOMIC_RELAXED);
+  while (!__atomic_compare_exchange_n(c, &cur, v4_le_to_host(v4_le_to_host(cur) + n),
+                                      true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+  {
+  }
+  *old = v4_le_to_host(cur);
+#else
+  *old = __atomic_fetch_add(c, n, __ATOMIC_SEQ_CST);
+#endif
+  return 0;
+}
+
 /* ---- 8-bit and 16-bit accessors ---- */
+template <V4MemPath P>
 v4_err v4_mem_read8_core(Vm *vm, v4_u32 addr, v4_u32 *out)
 {
-  // No MMIO support for 8-bit access (could be added if needed)
+  // MMIO window or host memory?
+  if (const VmDecodeRange *d = decode_lookup(vm, addr))
+  {
+    if (d->kind == V4_DECODE_HOST)
+    {
+      const uint8_t *p = host_ptr(d, addr, 1, V4_REGION_READ);
+      if (!p)
+        return V4_ERR(OobMemory);
+      *out = (v4_u32)*p;
+      return 0;
+    }
+    const V4_Mmio *m = &vm->mmio[d->index];
+    if (!m->read8)
+      return V4_ERR(OobMemory);  // forbidden
+    v4_u8 v = 0;
+    const v4_err e = m->read8(m->user, addr, &v);
+    *out = v;
+    return e;
+  }
+
+  if constexpr (P == V4_MEM_PATH_MASKED)
+  {
+    *out = (v4_u32)vm->mem[addr & vm->mem_mask];
+    return 0;
+  }
+
+#ifdef V4_HAVE_GUARDED_MEM
+  if constexpr (P == V4_MEM_PATH_GUARDED)
+  {
+    *out = (v4_u32)vm->mem[addr];
+    return 0;
+  }
+#endif
+
   // RAM range check
   if (int e = v4_is_in_ram(vm, addr, 1))
     return e;
@@ -112,9 +529,46 @@ v4_err v4_mem_read8_core(Vm *vm, v4_u32 addr, v4_u32 *out)
   return 0;
 }
 
+template <V4MemPath P>
 v4_err v4_mem_read16_core(Vm *vm, v4_u32 addr, v4_u32 *out)
 {
-  // No MMIO support for 16-bit access (could be added if needed)
+  // MMIO window or host memory?
+  if (const VmDecodeRange *d = decode_lookup(vm, addr))
+  {
+    if (d->kind == V4_DECODE_HOST)
+    {
+      const uint8_t *p = host_ptr(d, addr, 2, V4_REGION_READ);
+      if (!p)
+        return V4_ERR(OobMemory);
+      *out = (v4_u32)ld_le16(p);
+      return 0;
+    }
+    const V4_Mmio *m = &vm->mmio[d->index];
+    if (!m->read16 || addr == d->last)
+      return V4_ERR(OobMemory);  // forbidden, or the high byte leaves the window
+    v4_u16 v = 0;
+    const v4_err e = m->read16(m->user, addr, &v);
+    *out = v;
+    return e;
+  }
+
+  if constexpr (P == V4_MEM_PATH_MASKED)
+  {
+    // May read one byte into the guard tail
+    *out = (v4_u32)ld_le16(&vm->mem[addr & vm->mem_mask]);
+    return 0;
+  }
+
+#ifdef V4_HAVE_GUARDED_MEM
+  if constexpr (P == V4_MEM_PATH_GUARDED)
+  {
+    uint16_t v;
+    memcpy(&v, &vm->mem[addr], 2);
+    *out = (v4_u32)v;
+    return 0;
+  }
+#endif
+
   // RAM range check
   if (int e = v4_is_in_ram(vm, addr, 2))
     return e;
@@ -125,31 +579,153 @@ v4_err v4_mem_read16_core(Vm *vm, v4_u32 addr, v4_u32 *out)
   return 0;
 }
 
+template <V4MemPath P>
 v4_err v4_mem_write8_core(Vm *vm, v4_u32 addr, v4_u32 val)
 {
-  // No MMIO support for 8-bit access
+  // MMIO window or host memory?
+  if (const VmDecodeRange *d = decode_lookup(vm, addr))
+  {
+    if (d->kind == V4_DECODE_HOST)
+    {
+      uint8_t *p = host_ptr(d, addr, 1, V4_REGION_WRITE);
+      if (!p)
+        return V4_ERR(OobMemory);
+      *p = (uint8_t)(val & 0xFF);
+      return 0;
+    }
+    const V4_Mmio *m = &vm->mmio[d->index];
+    if (!m->write8)
+      return V4_ERR(OobMemory);  // forbidden
+    return m->write8(m->user, addr, (v4_u8)(val & 0xFF));
+  }
+
+  if constexpr (P == V4_MEM_PATH_MASKED)
+  {
+    v4_mem_note_write(vm, addr & vm->mem_mask, 1);
+    vm->mem[addr & vm->mem_mask] = (uint8_t)(val & 0xFF);
+    return 0;
+  }
+
+#ifdef V4_HAVE_GUARDED_MEM
+  if constexpr (P == V4_MEM_PATH_GUARDED)
+  {
+    v4_mem_note_write(vm, addr, 1);
+    vm->mem[addr] = (uint8_t)(val & 0xFF);
+    return 0;
+  }
+#endif
+
   // RAM range check
   if (int e = v4_is_in_ram(vm, addr, 1))
     return e;
 
   // Store byte
+  v4_mem_note_write(vm, addr, 1);
   vm->mem[addr] = (uint8_t)(val & 0xFF);
   return 0;
 }
 
+template <V4MemPath P>
 v4_err v4_mem_write16_core(Vm *vm, v4_u32 addr, v4_u32 val)
 {
-  // No MMIO support for 16-bit access
+  // MMIO window or host memory?
+  if (const VmDecodeRange *d = decode_lookup(vm, addr))
+  {
+    if (d->kind == V4_DECODE_HOST)
+    {
+      uint8_t *p = host_ptr(d, addr, 2, V4_REGION_WRITE);
+      if (!p)
+        return V4_ERR(OobMemory);
+      st_le16(p, (uint16_t)(val & 0xFFFF));
+      return 0;
+    }
+    const V4_Mmio *m = &vm->mmio[d->index];
+    if (!m->write16 || addr == d->last)
+      return V4_ERR(OobMemory);  // forbidden, or the high byte leaves the window
+    return m->write16(m->user, addr, (v4_u16)(val & 0xFFFF));
+  }
+
+  if constexpr (P == V4_MEM_PATH_MASKED)
+  {
+    // May write one byte into the guard tail
+    v4_mem_note_write(vm, addr & vm->mem_mask, 2);
+    st_le16(&vm->mem[addr & vm->mem_mask], (uint16_t)(val & 0xFFFF));
+    return 0;
+  }
+
+#ifdef V4_HAVE_GUARDED_MEM
+  if constexpr (P == V4_MEM_PATH_GUARDED)
+  {
+    const uint16_t v = (uint16_t)(val & 0xFFFF);
+    v4_mem_note_write(vm, addr, 2);
+    memcpy(&vm->mem[addr], &v, 2);
+    return 0;
+  }
+#endif
+
   // RAM range check
   if (int e = v4_is_in_ram(vm, addr, 2))
     return e;
 
   // No alignment requirement for 16-bit access
   // Store 16-bit (little-endian)
+  v4_mem_note_write(vm, addr, 2);
   st_le16(&vm->mem[addr], (uint16_t)(val & 0xFFFF));
   return 0;
 }
 
+/* Every path is built for the exec loops in core.cpp (guarded only where
+ * available); other callers get the path of the VM's RAM mode. */
+#define V4_MEM_PATH_INSTANTIATE(P)                                    \
+  template v4_err v4_mem_read32_core<P>(Vm *, v4_u32, v4_u32 *);      \
+  template v4_err v4_mem_write32_core<P>(Vm *, v4_u32, v4_u32);       \
+  template v4_err v4_mem_read8_core<P>(Vm *, v4_u32, v4_u32 *);       \
+  template v4_err v4_mem_read16_core<P>(Vm *, v4_u32, v4_u32 *);      \
+  template v4_err v4_mem_write8_core<P>(Vm *, v4_u32, v4_u32);        \
+  template v4_err v4_mem_write16_core<P>(Vm *, v4_u32, v4_u32);
+V4_MEM_PATH_INSTANTIATE(V4_MEM_PATH_CHECKED)
+V4_MEM_PATH_INSTANTIATE(V4_MEM_PATH_MASKED)
+#ifdef V4_HAVE_GUARDED_MEM
+V4_MEM_PATH_INSTANTIATE(V4_MEM_PATH_GUARDED)
+#endif
+#undef V4_MEM_PATH_INSTANTIATE
+
+v4_err v4_mem_read32_core(Vm *vm, v4_u32 addr, v4_u32 *out)
+{
+  return vm->mem_mask ? v4_mem_read32_core<V4_MEM_PATH_MASKED>(vm, addr, out)
+                      : v4_mem_read32_core<V4_MEM_PATH_CHECKED>(vm, addr, out);
+}
+
+v4_err v4_mem_write32_core(Vm *vm, v4_u32 addr, v4_u32 val)
+{
+  return vm->mem_mask ? v4_mem_write32_core<V4_MEM_PATH_MASKED>(vm, addr, val)
+                      : v4_mem_write32_core<V4_MEM_PATH_CHECKED>(vm, addr, val);
+}
+
+v4_err v4_mem_read8_core(Vm *vm, v4_u32 addr, v4_u32 *out)
+{
+  return vm->mem_mask ? v4_mem_read8_core<V4_MEM_PATH_MASKED>(vm, addr, out)
+                      : v4_mem_read8_core<V4_MEM_PATH_CHECKED>(vm, addr, out);
+}
+
+v4_err v4_mem_read16_core(Vm *vm, v4_u32 addr, v4_u32 *out)
+{
+  return vm->mem_mask ? v4_mem_read16_core<V4_MEM_PATH_MASKED>(vm, addr, out)
+                      : v4_mem_read16_core<V4_MEM_PATH_CHECKED>(vm, addr, out);
+}
+
+v4_err v4_mem_write8_core(Vm *vm, v4_u32 addr, v4_u32 val)
+{
+  return vm->mem_mask ? v4_mem_write8_core<V4_MEM_PATH_MASKED>(vm, addr, val)
+                      : v4_mem_write8_core<V4_MEM_PATH_CHECKED>(vm, addr, val);
+}
+
+v4_err v4_mem_write16_core(Vm *vm, v4_u32 addr, v4_u32 val)
+{
+  return vm->mem_mask ? v4_mem_write16_core<V4_MEM_PATH_MASKED>(vm, addr, val)
+                      : v4_mem_write16_core<V4_MEM_PATH_CHECKED>(vm, addr, val);
+}
+
 /* ---- public API: direct memory access (for tests/embedding) ---- */
 extern "C" v4_err vm_mem_read32(struct Vm *vmp, v4_u32 addr, v4_u32 *out)
 {
@@ -166,15 +742,138 @@ extern "C" v4_err vm_mem_write32(struct Vm *vmp, v4_u32 addr, v4_u32 val)
   return e;
 }
 
+/* ---- public API: bulk transfer and zero-copy views ---- */
+
+/* Host pointer for [addr, addr + len) in RAM or one region; notes RAM writes. */
+static uint8_t *block_ptr(Vm *vm, v4_u32 addr, v4_u32 len, v4_u32 need)
+{
+  uint8_t *p = v4_mem_host_range(vm, addr, len, need);
+  if (p && (need & V4_REGION_WRITE) && p >= vm->mem && p < vm->mem + vm->mem_size)
+    v4_mem_note_write(vm, addr, len);
+  return p;
+}
+
+/* Callback window covering all of [addr, addr + len), or NULL. */
+static const V4_Mmio *block_mmio(Vm *vm, v4_u32 addr, v4_u32 len)
+{
+  const VmDecodeRange *d = decode_lookup(vm, addr);
+  if (!d || d->kind != V4_DECODE_MMIO ||
+      (uint64_t)(addr - d->lo) + len > (uint64_t)(d->last - d->lo) + 1)
+    return nullptr;
+  return &vm->mmio[d->index];
+}
+
+/* Burst callback, else one 32-bit call per cell, else one 8-bit call per byte. */
+static v4_err mmio_read_block(const V4_Mmio *m, v4_u32 addr, uint8_t *dst, v4_u32 len)
+{
+  if (m->read_block)
+    return m->read_block(m->user, addr, dst, len);
+  if (m->read32 && ((addr | len) & 3u) == 0)
+  {
+    for (v4_u32 i = 0; i < len; i += 4)
+    {
+      v4_u32 v;
+      if (v4_err e = m->read32(m->user, addr + i, &v))
+        return e;
+      st_le32(dst + i, v);
+    }
+    return 0;
+  }
+  if (!m->read8)
+    return V4_ERR(OobMemory);
+  for (v4_u32 i = 0; i < len; i++)
+    if (v4_err e = m->read8(m->user, addr + i, &dst[i]))
+      return e;
+  return 0;
+}
+
+static v4_err mmio_write_block(const V4_Mmio *m, v4_u32 addr, const uint8_t *src,
+                               v4_u32 len)
+{
+  if (m->write_block)
+    return m->write_block(m->user, addr, src, len);
+  if (m->write32 && ((addr | len) & 3u) == 0)
+  {
+    for (v4_u32 i = 0; i < len; i += 4)
+      if (v4_err e = m->write32(m->user, addr + i, ld_le32(src + i)))
+        return e;
+    return 0;
+  }
+  if (!m->write8)
+    return V4_ERR(OobMemory);
+  for (v4_u32 i = 0; i < len; i++)
+    if (v4_err e = m->write8(m->user, addr + i, src[i]))
+      return e;
+  return 0;
+}
+
+extern "C" v4_err vm_mem_read_block(struct Vm *vm, v4_u32 addr, void *dst, v4_u32 len)
+{
+  if (!vm || (!dst && len))
+    return V4_ERR(InvalidArg);
+  v4_err e = 0;
+  if (len)
+  {
+    const uint8_t *p = block_ptr(vm, addr, len, V4_REGION_READ);
+    const V4_Mmio *m;
+    if (p)
+      ::memcpy(dst, p, len);
+    else if ((m = block_mmio(vm, addr, len)) != nullptr)
+      e = mmio_read_block(m, addr, (uint8_t *)dst, len);
+    else
+      e = V4_ERR(OobMemory);
+  }
+  vm->last_err = e;
+  return e;
+}
+
+extern "C" v4_err vm_mem_write_block(struct Vm *vm, v4_u32 addr, const void *src,
+                                     v4_u32 len)
+{
+  if (!vm || (!src && len))
+    return V4_ERR(InvalidArg);
+  v4_err e = 0;
+  if (len)
+  {
+    uint8_t *p = block_ptr(vm, addr, len, V4_REGION_WRITE);
+    const V4_Mmio *m;
+    if (p)
+      ::memcpy(p, src, len);
+    else if ((m = block_mmio(vm, addr, len)) != nullptr)
+      e = mmio_write_block(m, addr, (const uint8_t *)src, len);
+    else
+      e = V4_ERR(OobMemory);
+  }
+  vm->last_err = e;
+  return e;
+}
+
+extern "C" uint8_t *vm_mem_view(struct Vm *vm, v4_u32 addr, v4_u32 len, int writable)
+{
+  if (!vm)
+    return nullptr;
+  return block_ptr(vm, addr, len, writable ? V4_REGION_READ | V4_REGION_WRITE
+                                           : V4_REGION_READ);
+}
+
 /* ---- public API: lifecycle & MMIO registration ---- */
 extern "C" struct Vm *vm_create(const VmConfig *cfg)
 {
   if (!cfg)
     return nullptr;
-  Vm *vm = (Vm *)::malloc(sizeof(Vm));
+  Vm *vm = (Vm *)v4_alloc(cfg->arena, sizeof(Vm));
   if (!vm)
     return nullptr;
   ::memset(vm, 0, sizeof(Vm));
+  vm->cow_fd = -1;
+
+  // Arena allocator (optional; backs all VM storage in V4_NO_MALLOC builds)
+  vm->arena = cfg->arena;
+
+  // Dictionary sizing; storage is allocated by the first vm_register_word()
+  vm->dict_init = cfg->dict_words <= INT32_MAX ? (int)cfg->dict_words : INT32_MAX;
+  vm->dict_max = cfg->dict_max_words <= INT32_MAX ? (int)cfg->dict_max_words : INT32_MAX;
+  vm->code_size = cfg->code_arena_size;  // allocated on the first copy
 
   // Stacks
   vm_reset(vm);  // declared in vm_api.h / defined in vm_core.cpp
@@ -182,26 +881,208 @@ extern "C" struct Vm *vm_create(const VmConfig *cfg)
   // Memory config
   vm->mem = cfg->mem;
   vm->mem_size = cfg->mem_size;
+  if (cfg->mem_file)
+  {
+    // VM owns file-backed RAM; masked mode also maps the guard tail
+    const size_t len =
+        (size_t)cfg->mem_size + (cfg->mem_mode == V4_MEM_MASKED ? V4_MEM_GUARD_BYTES : 0);
+    if (cfg->mem || cfg->mem_mode == V4_MEM_GUARDED || cfg->mem_mode == V4_MEM_PAGED ||
+        v4_mem_file_map(vm, cfg->mem_file, len) != 0)
+    {
+      v4_dealloc(cfg->arena, vm, sizeof(Vm));
+      return nullptr;
+    }
+    vm->mem_sync = (uint8_t)cfg->mem_sync;
+  }
+  switch (cfg->mem_mode)
+  {
+    case V4_MEM_CHECKED:
+      break;
+    case V4_MEM_MASKED:
+      // Power-of-two RAM, at least one aligned cell
+      if (!vm->mem || cfg->mem_size < 4 || (cfg->mem_size & (cfg->mem_size - 1)))
+      {
+        v4_mem_file_unmap(vm);
+        v4_dealloc(cfg->arena, vm, sizeof(Vm));
+        return nullptr;
+      }
+      vm->mem_mask = cfg->mem_size - 1;
+      break;
+    case V4_MEM_GUARDED:
+      // VM owns the RAM so it can surround it with guard pages
+      if (cfg->mem || v4_guard_alloc(vm, cfg->mem_size) != 0)
+      {
+        v4_dealloc(cfg->arena, vm, sizeof(Vm));
+        return nullptr;
+      }
+      break;
+    case V4_MEM_PAGED:
+      // VM owns the RAM; the host backs pages as they are first written
+      if (cfg->mem || v4_paged_alloc(vm, cfg->mem_size) != 0)
+      {
+        v4_dealloc(cfg->arena, vm, sizeof(Vm));
+        return nullptr;
+      }
+      break;
+    default:
+      v4_mem_file_unmap(vm);
+      v4_dealloc(cfg->arena, vm, sizeof(Vm));
+      return nullptr;
+  }
 
-  // MMIO table (linear, fixed capacity)
-  vm->mmio_count = 0;
-  if (cfg->mmio && cfg->mmio_count > 0)
+  // Extra memory regions (copied; backing stores stay with the caller)
+  if (cfg->regions && cfg->region_count > 0)
   {
-    const int cap = Vm::V4_MAX_MMIO;  // from internal vm.h
-    const int n = (cfg->mmio_count <= cap) ? cfg->mmio_count : cap;
-    for (int i = 0; i < n; ++i)
-      vm->mmio[i] = cfg->mmio[i];
-    vm->mmio_count = n;
+    // Shared cells are accessed atomically: host and VM alignment must agree
+    for (int i = 0; i < cfg->region_count; i++)
+    {
+      const V4_Region *r = &cfg->regions[i];
+      if ((r->flags & V4_REGION_SHARED) && (((uintptr_t)r->data | r->base) & 3u))
+      {
+        vm_destroy(vm);
+        return nullptr;
+      }
+    }
+    const size_t bytes = sizeof(V4_Region) * (size_t)cfg->region_count;
+    vm->regions = (V4_Region *)v4_alloc(vm->arena, bytes);
+    if (!vm->regions)
+    {
+      vm_destroy(vm);
+      return nullptr;
+    }
+    ::memcpy(vm->regions, cfg->regions, bytes);
+    vm->region_count = cfg->region_count;
+    if (decode_rebuild(vm) != 0)
+    {
+      vm_destroy(vm);
+      return nullptr;
+    }
   }
 
-  // Arena allocator (optional)
-  vm->arena = cfg->arena;
+  // MMIO windows + decode table
+  if (cfg->mmio && cfg->mmio_count > 0 &&
+      vm_register_mmio(vm, cfg->mmio, cfg->mmio_count) != 0)
+  {
+    vm_destroy(vm);
+    return nullptr;
+  }
+
+  // ALLOCATE/FREE heap inside RAM (optional)
+  if (cfg->heap_size > 0 && vm_heap_init(vm, cfg->heap_base, cfg->heap_size) != 0)
+  {
+    vm_destroy(vm);
+    return nullptr;
+  }
 
   vm->last_err = 0;
   vm->boot_cfg_snapshot = cfg;
   return vm;
 }
 
+static void *dup_bytes(V4Arena *arena, const void *src, size_t n)
+{
+  if (!src || n == 0)
+    return nullptr;
+  void *p = v4_alloc(arena, n);
+  if (p)
+    ::memcpy(p, src, n);
+  return p;
+}
+
+extern "C" struct Vm *vm_fork(struct Vm *tmpl)
+{
+  if (!tmpl)
+    return nullptr;
+  if (tmpl->mem && v4_cow_snapshot(tmpl) != 0)
+    return nullptr;
+
+  Vm *vm = (Vm *)v4_alloc(tmpl->arena, sizeof(Vm));
+  if (!vm)
+    return nullptr;
+  ::memset(vm, 0, sizeof(Vm));
+  vm->cow_fd = -1;
+#ifdef V4_NO_MALLOC
+  vm->arena = tmpl->arena;  // the fork's only source of storage
+#endif
+  vm->fork_parent = tmpl;
+  tmpl->fork_count++;
+
+  // RAM: private copy-on-write view of the template image
+  vm->mem_size = tmpl->mem_size;
+  vm->mem_mask = tmpl->mem_mask;
+  if (tmpl->mem && v4_cow_map(vm, tmpl) != 0)
+  {
+    tmpl->fork_count--;
+    v4_dealloc(tmpl->arena, vm, sizeof(Vm));
+    return nullptr;
+  }
+
+  // Stacks: copy live cells only
+  const ptrdiff_t ds = tmpl->sp - tmpl->DS;
+  const ptrdiff_t rs = tmpl->rp - tmpl->RS;
+  ::memcpy(vm->DS, tmpl->DS, sizeof(v4_i32) * (size_t)ds);
+  ::memcpy(vm->RS, tmpl->RS, sizeof(v4_i32) * (size_t)rs);
+  vm->sp = vm->DS + ds;
+  vm->rp = vm->RS + rs;
+  vm->fp = tmpl->fp ? vm->RS + (tmpl->fp - tmpl->RS) : nullptr;
+
+  // Address map: small tables, copied so the fork can register its own
+  const size_t mmio_bytes = sizeof(V4_Mmio) * (size_t)tmpl->mmio_count;
+  const size_t region_bytes = sizeof(V4_Region) * (size_t)tmpl->region_count;
+  const size_t decode_bytes = sizeof(VmDecodeRange) * (size_t)tmpl->decode_count;
+  const size_t shadow_bytes = sizeof(uint32_t) * (((size_t)tmpl->decode_pages + 31) / 32);
+  vm->mmio = (V4_Mmio *)dup_bytes(vm->arena, tmpl->mmio, mmio_bytes);
+  vm->regions = (V4_Region *)dup_bytes(vm->arena, tmpl->regions, region_bytes);
+  vm->decode = (VmDecodeRange *)dup_bytes(vm->arena, tmpl->decode, decode_bytes);
+  vm->decode_shadow = (uint32_t *)dup_bytes(vm->arena, tmpl->decode_shadow, shadow_bytes);
+  vm->decode_pages = tmpl->decode_pages;
+  if ((mmio_bytes && !vm->mmio) || (region_bytes && !vm->regions) ||
+      (decode_bytes && !vm->decode) || (tmpl->decode_shadow && !vm->decode_shadow))
+  {
+    vm_destroy(vm);
+    return nullptr;
+  }
+  vm->mmio_count = vm->mmio_cap = tmpl->mmio_count;
+  vm->region_count = tmpl->region_count;
+  vm->decode_count = vm->decode_cap = tmpl->decode_count;
+  vm->decode_lo = tmpl->decode_lo;
+  vm->decode_hull = tmpl->decode_hull;
+  vm->heap_ctl = tmpl->heap_ctl;
+  vm->heap_size = tmpl->heap_size;
+
+  // Dictionary: names and bytecode (code arena included) stay owned by the
+  // template; words that execute in place from template RAM are rebased
+  // onto the fork's view
+  vm->dict_init = tmpl->dict_init;
+  vm->dict_max = tmpl->dict_max;
+  vm->code_size = tmpl->code_size;  // for the fork's own words
+  while (vm->word_cap < tmpl->word_count)
+  {
+    if (!v4_dict_grow(vm))
+    {
+      vm_destroy(vm);
+      return nullptr;
+    }
+  }
+  for (int i = 0; i < tmpl->word_count; i++)
+  {
+    const Word *src = v4_dict_word(tmpl, i);
+    Word *dst = v4_dict_word(vm, i);
+    dst->code = src->code;
+    if (tmpl->mem && src->code >= tmpl->mem && src->code < tmpl->mem + tmpl->mem_size)
+      dst->code = vm->mem + (src->code - tmpl->mem);
+    dst->code_len = src->code_len;
+    *v4_word_name(dst) = *v4_word_name(src);
+  }
+  vm->word_count = tmpl->word_count;
+  vm->dict_base = tmpl->word_count;
+
+  vm->boot_cfg_snapshot = tmpl->boot_cfg_snapshot;
+  vm->panic_handler = tmpl->panic_handler;
+  vm->panic_user_data = tmpl->panic_user_data;
+  return vm;
+}
+
 extern "C" void vm_destroy(struct Vm *vm)
 {
   if (!vm)
@@ -210,18 +1091,45 @@ extern "C" void vm_destroy(struct Vm *vm)
   // Free word names only if using malloc (not arena)
   if (!vm->arena)
   {
-    for (int i = 0; i < vm->word_count; i++)
+    for (int i = vm->dict_base; i < vm->word_count; i++)
     {
-      if (vm->words[i].name)
+      WordName *w = v4_word_name(v4_dict_word(vm, i));
+      if (w->name)
       {
-        ::free(vm->words[i].name);
-        vm->words[i].name = nullptr;
+        v4_dealloc(nullptr, w->name, 0);
+        w->name = nullptr;
       }
     }
   }
   // If using arena, names are managed by arena owner (user responsibility)
+  v4_dict_index_free(vm);
+  v4_word_calls_resize(vm, 0);
+  v4_dict_free(vm);
+  v4_code_free(vm);
+  if (vm->fork_parent)
+    vm->fork_parent->fork_count--;
 
-  ::free(vm);
+  v4_dealloc(vm->arena, vm->decode_shadow,
+             sizeof(uint32_t) * (((size_t)vm->decode_pages + 31) / 32));
+  v4_dealloc(vm->arena, vm->decode, sizeof(VmDecodeRange) * (size_t)vm->decode_cap);
+  v4_dealloc(vm->arena, vm->regions, sizeof(V4_Region) * (size_t)vm->region_count);
+  v4_dealloc(vm->arena, vm->mmio, sizeof(V4_Mmio) * (size_t)vm->mmio_cap);
+  v4_guard_free(vm);
+  v4_paged_free(vm);
+  v4_cow_unmap(vm);
+  v4_cow_release(vm);
+  vm_checkpoint_end(vm);
+  if (vm->mem_sync != V4_SYNC_NONE)
+    v4_mem_file_sync(vm, true);
+  v4_mem_file_unmap(vm);
+  v4_dealloc(vm->arena, vm, sizeof(Vm));
+}
+
+extern "C" v4_err vm_mem_sync(struct Vm *vm, int wait)
+{
+  if (!vm)
+    return V4_ERR(InvalidArg);
+  return v4_mem_file_sync(vm, wait != 0);
 }
 
 extern "C" v4_err vm_register_mmio(struct Vm *vmp, const V4_Mmio *list, int count)
@@ -229,13 +1137,29 @@ extern "C" v4_err vm_register_mmio(struct Vm *vmp, const V4_Mmio *list, int coun
   Vm *vm = (Vm *)vmp;
   if (!vm || !list || count <= 0)
     return V4_ERR(InvalidArg);
-  int appended = 0;
-  for (int i = 0; i < count; ++i)
+
+  const int need = vm->mmio_count + count;
+  if (need > vm->mmio_cap)
   {
-    if (vm->mmio_count >= Vm::V4_MAX_MMIO)
-      break;
-    vm->mmio[vm->mmio_count++] = list[i];
-    ++appended;
+    int cap = vm->mmio_cap ? vm->mmio_cap : 8;
+    while (cap < need)
+      cap *= 2;
+    V4_Mmio *grown = (V4_Mmio *)v4_realloc(vm->arena, vm->mmio,
+                                           sizeof(V4_Mmio) * (size_t)vm->mmio_cap,
+                                           sizeof(V4_Mmio) * (size_t)cap);
+    if (!grown)
+      return V4_ERR(NoMemory);
+    vm->mmio = grown;
+    vm->mmio_cap = cap;
+  }
+
+  const int old_count = vm->mmio_count;
+  ::memcpy(vm->mmio + old_count, list, sizeof(V4_Mmio) * (size_t)count);
+  vm->mmio_count = need;
+  if (v4_err e = decode_rebuild(vm))
+  {
+    vm->mmio_count = old_count;  // previous decode table is still in place
+    return e;
   }
-  return (appended == count) ? V4_ERR(OK) : V4_ERR(InvalidArg);
+  return V4_ERR(OK);
 }
@@ -0,0 +1,172 @@
+// src/paged_mem.cpp — sparse, lazily populated VM RAM
+#include "v4/internal/paged_mem.hpp"
+
+#include <string.h>
+
+#include "v4/errors.hpp"
+#include "v4/internal/memory.hpp"
+
+#ifdef V4_HAVE_PAGED_MEM
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+
+#ifdef __APPLE__
+typedef char mincore_vec_t;
+#else
+typedef unsigned char mincore_vec_t;
+#endif
+
+static size_t host_page()
+{
+  return (size_t)sysconf(_SC_PAGESIZE);
+}
+
+v4_err v4_paged_alloc(Vm *vm, v4_u32 mem_size)
+{
+  if (mem_size == 0)
+    return V4_ERR(InvalidArg);
+
+  const size_t page = host_page();
+  const size_t len = ((size_t)mem_size + page - 1) & ~(page - 1);
+  void *p = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (p == MAP_FAILED)
+    return V4_ERR(NoMemory);
+
+  vm->page_map = p;
+  vm->page_map_len = len;
+  vm->mem = (uint8_t *)p;
+  vm->mem_size = mem_size;
+  return V4_ERR(OK);
+}
+
+void v4_paged_free(Vm *vm)
+{
+  if (!vm->page_map)
+    return;
+  munmap(vm->page_map, vm->page_map_len);
+  vm->page_map = nullptr;
+  vm->page_map_len = 0;
+  vm->mem = nullptr;
+}
+
+/* Call fn(offset, bytes) for each run of host-resident pages of RAM, in
+ * bounded mincore() batches. Returns false if RAM is not inspectable. */
+template <typename Fn>
+static bool for_each_resident(const Vm *vm, Fn fn)
+{
+  const size_t page = host_page();
+  const uintptr_t lo = (uintptr_t)vm->mem & ~(uintptr_t)(page - 1);
+  const uintptr_t hi = (uintptr_t)vm->mem + vm->mem_size;
+  mincore_vec_t vec[256];
+  for (uintptr_t a = lo; a < hi;)
+  {
+    const size_t pages = (hi - a + page - 1) / page;
+    const size_t n = pages < sizeof(vec) ? pages : sizeof(vec);
+    if (mincore((void *)a, n * page, vec) != 0)
+      return false;
+    for (size_t i = 0; i < n; i++)
+    {
+      if (!(vec[i] & 1))
+        continue;
+      // Clip the page to RAM (the first page may start before mem)
+      const uintptr_t s = a + i * page < (uintptr_t)vm->mem ? (uintptr_t)vm->mem
+                                                            : a + i * page;
+      const uintptr_t e = a + (i + 1) * page < hi ? a + (i + 1) * page : hi;
+      fn((size_t)(s - (uintptr_t)vm->mem), (size_t)(e - s));
+    }
+    a += n * page;
+  }
+  return true;
+}
+
+void v4_paged_copy(const Vm *vm, uint8_t *dst)
+{
+  const uint8_t *src = vm->mem;
+  if (!for_each_resident(vm, [&](size_t off, size_t n) { memcpy(dst + off, src + off, n); }))
+    memcpy(dst, src, vm->mem_size);
+}
+
+extern "C" size_t vm_mem_resident(struct Vm *vm)
+{
+  if (!vm || !vm->mem || vm->mem_size == 0)
+    return 0;
+  size_t bytes = 0;
+  if (!for_each_resident(vm, [&](size_t, size_t n) { bytes += n; }))
+    return vm->mem_size;  // not a mapping we can inspect: assume backed
+  return bytes;
+}
+
+extern "C" v4_err vm_mem_discard(struct Vm *vm, v4_u32 addr, v4_u32 len)
+{
+  if (!vm)
+    return V4_ERR(InvalidArg);
+  if (len == 0)
+    return V4_ERR(OK);
+  uint8_t *p = v4_ram_range(vm, addr, len);
+  if (!p)
+    return V4_ERR(OobMemory);
+  v4_mem_note_write(vm, addr, len);
+
+  // Only owned anonymous pages read back as zero after MADV_DONTNEED;
+  // caller buffers, file-backed and forked RAM are cleared in place
+  if (vm->page_map)
+  {
+    const size_t page = host_page();
+    const uintptr_t s = ((uintptr_t)p + page - 1) & ~(uintptr_t)(page - 1);
+    const uintptr_t e = ((uintptr_t)p + len) & ~(uintptr_t)(page - 1);
+    if (s < e && madvise((void *)s, e - s, MADV_DONTNEED) == 0)
+    {
+      memset(p, 0, s - (uintptr_t)p);
+      memset((void *)e, 0, (uintptr_t)p + len - e);
+      return V4_ERR(OK);
+    }
+  }
+  memset(p, 0, len);
+  return V4_ERR(OK);
+}
+
+#else  // !V4_HAVE_PAGED_MEM
+
+v4_err v4_paged_alloc(Vm *vm, v4_u32 mem_size)
+{
+  (void)vm;
+  (void)mem_size;
+  return V4_ERR(InvalidArg);
+}
+
+void v4_paged_free(Vm *vm)
+{
+  (void)vm;
+}
+
+void v4_paged_copy(const Vm *vm, uint8_t *dst)
+{
+  memcpy(dst, vm->mem, vm->mem_size);
+}
+
+extern "C" size_t vm_mem_resident(struct Vm *vm)
+{
+  return vm && vm->mem ? vm->mem_size : 0;
+}
+
+extern "C" v4_err vm_mem_discard(struct Vm *vm, v4_u32 addr, v4_u32 len)
+{
+  if (!vm)
+    return V4_ERR(InvalidArg);
+  if (len == 0)
+    return V4_ERR(OK);
+  uint8_t *p = v4_ram_range(vm, addr, len);
+  if (!p)
+    return V4_ERR(OobMemory);
+  v4_mem_note_write(vm, addr, len);
+  memset(p, 0, len);
+  return V4_ERR(OK);
+}
+
+#endif  // V4_HAVE_PAGED_MEM
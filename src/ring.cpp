@@ -0,0 +1,307 @@
+// src/ring.cpp — single-producer/single-consumer byte rings in VM memory
+#include <string.h>
+
+#include "v4/errors.hpp"
+#include "v4/internal/memory.hpp"
+#include "v4/internal/sys_kernels.hpp"
+#include "v4/internal/vm.h"
+#include "v4/vm_api.h"
+
+/*
+ * Ring at R (4-byte aligned, in RAM or a read/write region):
+ *   +0 head  free-running write index, stored only by the producer
+ *   +4 tail  free-running read index, stored only by the consumer
+ *   +8 cap   capacity in bytes, a power of two
+ *   +12 data[cap]
+ *
+ * Each side loads its own index relaxed and the other side's with acquire,
+ * copies, then publishes its index with release. One producer (task or
+ * ISR) and one consumer therefore need no critical section: a consumer
+ * that sees the new head also sees the bytes written before it, and a
+ * producer never reuses space before the consumer has released it.
+ * head - tail is the fill level; anything above cap means the header was
+ * overwritten.
+ */
+
+namespace
+{
+const v4_u32 kHdr = 12;
+const v4_u32 kMaxCap = 1u << 30;
+
+struct Ring
+{
+  v4_u32 *head;
+  v4_u32 *tail;
+  uint8_t *data;
+  v4_u32 cap;
+};
+
+/* Checkpoint tracking covers primary RAM only; regions are not rolled back. */
+void note(Vm *vm, const uint8_t *p, v4_u32 len)
+{
+  if (p >= vm->mem && p < vm->mem + vm->mem_size)
+    v4_mem_note_write(vm, (v4_u32)(p - vm->mem), len);
+}
+
+v4_u32 load(const v4_u32 *c, int order)
+{
+  return v4_le_to_host(__atomic_load_n(c, order));
+}
+
+void store(Vm *vm, v4_u32 *c, v4_u32 v)
+{
+  note(vm, (const uint8_t *)c, 4);
+  __atomic_store_n(c, v4_le_to_host(v), __ATOMIC_RELEASE);
+}
+
+v4_err open_ring(Vm *vm, v4_u32 addr, Ring *r)
+{
+  uint8_t *h = v4_mem_host_range(vm, addr, kHdr, V4_REGION_READ | V4_REGION_WRITE);
+  if (!h)
+    return V4_ERR(OobMemory);
+  if ((addr & 3u) || ((uintptr_t)h & 3u))
+    return V4_ERR(Unaligned);
+  r->head = (v4_u32 *)(void *)h;
+  r->tail = r->head + 1;
+  r->cap = load(r->head + 2, __ATOMIC_RELAXED);  // fixed after init
+  if (r->cap == 0 || r->cap > kMaxCap || (r->cap & (r->cap - 1)))
+    return V4_ERR(InvalidArg);
+  r->data = v4_mem_host_range(vm, addr + kHdr, r->cap, V4_REGION_READ | V4_REGION_WRITE);
+  return r->data ? V4_ERR(OK) : V4_ERR(OobMemory);
+}
+
+/* Producer side: copy up to len bytes in (all of them or none if `whole`). */
+v4_err put(Vm *vm, const Ring &r, const uint8_t *src, v4_u32 len, bool whole, v4_u32 *n)
+{
+  const v4_u32 head = load(r.head, __ATOMIC_RELAXED);
+  const v4_u32 used = head - load(r.tail, __ATOMIC_ACQUIRE);
+  if (used > r.cap)
+    return V4_ERR(InvalidArg);
+  v4_u32 k = r.cap - used;
+  if (len < k)
+    k = len;
+  else if (whole && len > k)
+    k = 0;
+  *n = k;
+  if (k == 0)
+    return V4_ERR(OK);
+
+  const v4_u32 at = head & (r.cap - 1);
+  const v4_u32 first = k < r.cap - at ? k : r.cap - at;
+  note(vm, r.data + at, first);
+  memmove(r.data + at, src, first);
+  if (k > first)
+  {
+    note(vm, r.data, k - first);
+    memmove(r.data, src + first, k - first);
+  }
+  store(vm, r.head, head + k);
+  return V4_ERR(OK);
+}
+
+/* Consumer side: copy up to len bytes out (all of them or none if `whole`). */
+v4_err get(Vm *vm, const Ring &r, uint8_t *dst, v4_u32 len, bool whole, v4_u32 *n)
+{
+  const v4_u32 tail = load(r.tail, __ATOMIC_RELAXED);
+  const v4_u32 used = load(r.head, __ATOMIC_ACQUIRE) - tail;
+  if (used > r.cap)
+    return V4_ERR(InvalidArg);
+  v4_u32 k = used;
+  if (len < k)
+    k = len;
+  else if (whole && len > k)
+    k = 0;
+  *n = k;
+  if (k == 0)
+    return V4_ERR(OK);
+
+  const v4_u32 at = tail & (r.cap - 1);
+  const v4_u32 first = k < r.cap - at ? k : r.cap - at;
+  note(vm, dst, k);  // a VM buffer for RING_READ
+  memmove(dst, r.data + at, first);
+  if (k > first)
+    memmove(dst + first, r.data, k - first);
+  store(vm, r.tail, tail + k);
+  return V4_ERR(OK);
+}
+
+/* Resolve a VM (addr, len) buffer for a block transfer. */
+v4_err buffer(Vm *vm, v4_i32 addr, v4_i32 len, v4_u32 need, uint8_t **p)
+{
+  if (len < 0)
+    return V4_ERR(InvalidArg);
+  if (len == 0)
+  {
+    *p = nullptr;
+    return V4_ERR(OK);
+  }
+  *p = v4_mem_host_range(vm, (v4_u32)addr, (v4_u32)len, need);
+  return *p ? V4_ERR(OK) : V4_ERR(OobMemory);
+}
+}  // namespace
+
+/* ------------------------------------------------------------------------- */
+/* Public API                                                                */
+/* ------------------------------------------------------------------------- */
+
+extern "C" v4_err vm_ring_init(Vm *vm, v4_u32 addr, v4_u32 cap)
+{
+  if (!vm || cap == 0 || cap > kMaxCap || (cap & (cap - 1)))
+    return V4_ERR(InvalidArg);
+  uint8_t *h = v4_mem_host_range(vm, addr, kHdr, V4_REGION_READ | V4_REGION_WRITE);
+  if (!h || !v4_mem_host_range(vm, addr + kHdr, cap, V4_REGION_READ | V4_REGION_WRITE))
+    return V4_ERR(OobMemory);
+  if ((addr & 3u) || ((uintptr_t)h & 3u))
+    return V4_ERR(Unaligned);
+
+  v4_u32 *c = (v4_u32 *)(void *)h;
+  note(vm, h, kHdr);
+  __atomic_store_n(&c[2], v4_le_to_host(cap), __ATOMIC_RELAXED);
+  __atomic_store_n(&c[1], 0u, __ATOMIC_RELAXED);
+  __atomic_store_n(&c[0], 0u, __ATOMIC_RELEASE);
+  return V4_ERR(OK);
+}
+
+extern "C" v4_i32 vm_ring_write(Vm *vm, v4_u32 ring, const void *src, v4_u32 len)
+{
+  if (!vm || (!src && len))
+    return V4_ERR(InvalidArg);
+  Ring r;
+  v4_u32 n;
+  if (v4_err e = open_ring(vm, ring, &r))
+    return e;
+  if (v4_err e = put(vm, r, (const uint8_t *)src, len, false, &n))
+    return e;
+  return (v4_i32)n;
+}
+
+extern "C" v4_i32 vm_ring_read(Vm *vm, v4_u32 ring, void *dst, v4_u32 len)
+{
+  if (!vm || (!dst && len))
+    return V4_ERR(InvalidArg);
+  Ring r;
+  v4_u32 n;
+  if (v4_err e = open_ring(vm, ring, &r))
+    return e;
+  if (v4_err e = get(vm, r, (uint8_t *)dst, len, false, &n))
+    return e;
+  return (v4_i32)n;
+}
+
+/* ------------------------------------------------------------------------- */
+/* SYS kernels                                                               */
+/* ------------------------------------------------------------------------- */
+
+/* ( addr cap -- ) */
+v4_err v4_k_ring_init(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  (void)out;
+  return vm_ring_init(vm, (v4_u32)in[0], (v4_u32)in[1]);
+}
+
+/* ( c ring -- flag ) */
+v4_err v4_k_ring_put(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  Ring r;
+  v4_u32 n;
+  const uint8_t c = (uint8_t)in[0];
+  if (v4_err e = open_ring(vm, (v4_u32)in[1], &r))
+    return e;
+  if (v4_err e = put(vm, r, &c, 1, true, &n))
+    return e;
+  out[0] = n ? V4_TRUE : V4_FALSE;
+  return V4_ERR(OK);
+}
+
+/* ( ring -- c flag ) */
+v4_err v4_k_ring_get(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  Ring r;
+  v4_u32 n;
+  uint8_t c = 0;
+  if (v4_err e = open_ring(vm, (v4_u32)in[0], &r))
+    return e;
+  if (v4_err e = get(vm, r, &c, 1, true, &n))
+    return e;
+  out[0] = c;
+  out[1] = n ? V4_TRUE : V4_FALSE;
+  return V4_ERR(OK);
+}
+
+/* ( x ring -- flag ) — the cell goes in as 4 little-endian bytes, or not at all */
+v4_err v4_k_ring_put_cell(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  Ring r;
+  v4_u32 n;
+  const v4_u32 x = (v4_u32)in[0];
+  const uint8_t b[4] = {(uint8_t)x, (uint8_t)(x >> 8), (uint8_t)(x >> 16),
+                        (uint8_t)(x >> 24)};
+  if (v4_err e = open_ring(vm, (v4_u32)in[1], &r))
+    return e;
+  if (v4_err e = put(vm, r, b, 4, true, &n))
+    return e;
+  out[0] = n ? V4_TRUE : V4_FALSE;
+  return V4_ERR(OK);
+}
+
+/* ( ring -- x flag ) */
+v4_err v4_k_ring_get_cell(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  Ring r;
+  v4_u32 n;
+  uint8_t b[4] = {0, 0, 0, 0};
+  if (v4_err e = open_ring(vm, (v4_u32)in[0], &r))
+    return e;
+  if (v4_err e = get(vm, r, b, 4, true, &n))
+    return e;
+  out[0] = (v4_i32)((v4_u32)b[0] | ((v4_u32)b[1] << 8) | ((v4_u32)b[2] << 16) |
+                    ((v4_u32)b[3] << 24));
+  out[1] = n ? V4_TRUE : V4_FALSE;
+  return V4_ERR(OK);
+}
+
+/* ( addr len ring -- n ) */
+v4_err v4_k_ring_write(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  Ring r;
+  v4_u32 n;
+  uint8_t *src;
+  if (v4_err e = buffer(vm, in[0], in[1], V4_REGION_READ, &src))
+    return e;
+  if (v4_err e = open_ring(vm, (v4_u32)in[2], &r))
+    return e;
+  if (v4_err e = put(vm, r, src, (v4_u32)in[1], false, &n))
+    return e;
+  out[0] = (v4_i32)n;
+  return V4_ERR(OK);
+}
+
+/* ( addr len ring -- n ) */
+v4_err v4_k_ring_read(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  Ring r;
+  v4_u32 n;
+  uint8_t *dst;
+  if (v4_err e = buffer(vm, in[0], in[1], V4_REGION_WRITE, &dst))
+    return e;
+  if (v4_err e = open_ring(vm, (v4_u32)in[2], &r))
+    return e;
+  if (v4_err e = get(vm, r, dst, (v4_u32)in[1], false, &n))
+    return e;
+  out[0] = (v4_i32)n;
+  return V4_ERR(OK);
+}
+
+/* ( ring -- used free ) */
+v4_err v4_k_ring_count(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  Ring r;
+  if (v4_err e = open_ring(vm, (v4_u32)in[0], &r))
+    return e;
+  const v4_u32 used = load(r.head, __ATOMIC_ACQUIRE) - load(r.tail, __ATOMIC_ACQUIRE);
+  if (used > r.cap)
+    return V4_ERR(InvalidArg);
+  out[0] = (v4_i32)used;
+  out[1] = (v4_i32)(r.cap - used);
+  return V4_ERR(OK);
+}
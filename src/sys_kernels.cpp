@@ -0,0 +1,65 @@
+// src/sys_kernels.cpp — core SYS kernel table (IDs 0x0100-0x01FF)
+#include "v4/internal/sys_kernels.hpp"
+
+#include "v4/sys_ids.h"
+
+/* Sorted by ID; looked up with a binary search. */
+static const V4SysKernel kKernels[] = {
+    /* Checksum and hash kernels: ( addr len seed -- value ) */
+    {V4_SYS_CRC32, 3, 1, v4_k_crc32},
+    {V4_SYS_CRC32C, 3, 1, v4_k_crc32c},
+    {V4_SYS_CRC16_CCITT, 3, 1, v4_k_crc16_ccitt},
+    {V4_SYS_FNV1A32, 3, 1, v4_k_fnv1a32},
+    {V4_SYS_XXH32, 3, 1, v4_k_xxh32},
+
+    /* Byte search and scanning kernels */
+    {V4_SYS_FIND_BYTE, 3, 1, v4_k_find_byte},   /* ( addr len byte -- off ) */
+    {V4_SYS_FIND_ANY, 4, 1, v4_k_find_any},     /* ( addr len set set_len -- off ) */
+    {V4_SYS_FIND_SUB, 4, 1, v4_k_find_sub},     /* ( addr len pat pat_len -- off ) */
+    {V4_SYS_SKIP_WS, 2, 1, v4_k_skip_ws},       /* ( addr len -- off ) */
+    {V4_SYS_PARSE_DEC, 2, 2, v4_k_parse_dec},   /* ( addr len -- value count ) */
+    {V4_SYS_PARSE_HEX, 2, 2, v4_k_parse_hex},   /* ( addr len -- value count ) */
+
+    /* Number formatting and buffered console output */
+    {V4_SYS_FMT_DEC, 3, 1, v4_k_fmt_dec},       /* ( n addr cap -- len ) */
+    {V4_SYS_FMT_UDEC, 3, 1, v4_k_fmt_udec},     /* ( u addr cap -- len ) */
+    {V4_SYS_FMT_HEX, 4, 1, v4_k_fmt_hex},       /* ( u width addr cap -- len ) */
+    {V4_SYS_FMT_FIXED, 4, 1, v4_k_fmt_fixed},   /* ( n frac addr cap -- len ) */
+#ifndef V4_USE_V4STD
+    {V4_SYS_TYPE, 2, 1, v4_k_type},             /* ( addr len -- err ) */
+#endif
+    {V4_SYS_ALLOCATE, 1, 2, v4_k_allocate},     /* ( u -- addr ior ) */
+    {V4_SYS_FREE, 1, 1, v4_k_free},             /* ( addr -- ior ) */
+    {V4_SYS_RESIZE, 2, 2, v4_k_resize},         /* ( addr u -- addr' ior ) */
+    {V4_SYS_HEAP_STATS, 0, 3, v4_k_heap_stats}, /* ( -- free largest frag% ) */
+
+    /* SPSC ring buffers */
+    {V4_SYS_RING_INIT, 2, 0, v4_k_ring_init},         /* ( addr cap -- ) */
+    {V4_SYS_RING_PUT, 2, 1, v4_k_ring_put},           /* ( c ring -- flag ) */
+    {V4_SYS_RING_GET, 1, 2, v4_k_ring_get},           /* ( ring -- c flag ) */
+    {V4_SYS_RING_PUT_CELL, 2, 1, v4_k_ring_put_cell}, /* ( x ring -- flag ) */
+    {V4_SYS_RING_GET_CELL, 1, 2, v4_k_ring_get_cell}, /* ( ring -- x flag ) */
+    {V4_SYS_RING_WRITE, 3, 1, v4_k_ring_write},       /* ( addr len ring -- n ) */
+    {V4_SYS_RING_READ, 3, 1, v4_k_ring_read},         /* ( addr len ring -- n ) */
+    {V4_SYS_RING_COUNT, 1, 2, v4_k_ring_count},       /* ( ring -- used free ) */
+};
+
+const V4SysKernel *v4_sys_kernel_find(uint16_t sys_id)
+{
+  if (sys_id < V4_SYS_KERNEL_FIRST || sys_id > V4_SYS_KERNEL_LAST)
+    return nullptr;
+
+  int lo = 0;
+  int hi = (int)(sizeof(kKernels) / sizeof(kKernels[0])) - 1;
+  while (lo <= hi)
+  {
+    const int mid = (lo + hi) / 2;
+    if (kKernels[mid].id == sys_id)
+      return &kKernels[mid];
+    if (kKernels[mid].id < sys_id)
+      lo = mid + 1;
+    else
+      hi = mid - 1;
+  }
+  return nullptr;
+}
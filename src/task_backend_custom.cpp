@@ -2,6 +2,7 @@
 #include <cstring>
 
 #include "v4/errors.hpp"
+#include "v4/internal/alloc.hpp"
 #include "v4/internal/scheduler.hpp"
 #include "v4/internal/task_backend.h"
 #include "v4/internal/vm.h"
@@ -16,6 +17,25 @@
  * custom scheduler (priority-based + round-robin).
  */
 
+/* Make *base hold at least n elements, reusing the current block if it is
+ * big enough. */
+static bool stack_reserve(Vm *vm, int32_t **base, uint16_t *cap, uint16_t n)
+{
+  if (*base && *cap >= n)
+    return true;
+  v4_dealloc(vm->arena, *base, sizeof(int32_t) * *cap);
+  *base = static_cast<int32_t *>(v4_alloc(vm->arena, sizeof(int32_t) * n));
+  *cap = *base ? n : 0;
+  return *base != nullptr;
+}
+
+static void stack_release(Vm *vm, int32_t **base, uint16_t *cap)
+{
+  v4_dealloc(vm->arena, *base, sizeof(int32_t) * *cap);
+  *base = nullptr;
+  *cap = 0;
+}
+
 extern "C" v4_err v4_backend_task_init(Vm *vm, uint32_t time_slice_ms)
 {
   if (!vm)
@@ -36,6 +56,8 @@ extern "C" v4_err v4_backend_task_init(Vm *vm, uint32_t time_slice_ms)
     vm->scheduler.tasks[i].state = V4_TASK_STATE_DEAD;
     vm->scheduler.tasks[i].ds_base = nullptr;
     vm->scheduler.tasks[i].rs_base = nullptr;
+    vm->scheduler.tasks[i].ds_cap = 0;
+    vm->scheduler.tasks[i].rs_cap = 0;
   }
 
   return V4_ERR(OK);
@@ -50,16 +72,8 @@ extern "C" v4_err v4_backend_task_cleanup(Vm *vm)
   for (int i = 0; i < V4_MAX_TASKS; i++)
   {
     v4_task_t *task = &vm->scheduler.tasks[i];
-    if (task->ds_base)
-    {
-      free(task->ds_base);
-      task->ds_base = nullptr;
-    }
-    if (task->rs_base)
-    {
-      free(task->rs_base);
-      task->rs_base = nullptr;
-    }
+    stack_release(vm, &task->rs_base, &task->rs_cap);
+    stack_release(vm, &task->ds_base, &task->ds_cap);
     task->state = V4_TASK_STATE_DEAD;
   }
 
@@ -104,19 +118,13 @@ extern "C" int v4_backend_task_spawn(Vm *vm, uint16_t word_idx, uint8_t priority
   if (rs_size == 0)
     rs_size = 64;
 
-  // Allocate independent stacks for task
-  task->ds_base = static_cast<int32_t *>(malloc(ds_size * sizeof(int32_t)));
-  task->rs_base = static_cast<int32_t *>(malloc(rs_size * sizeof(int32_t)));
-
-  if (!task->ds_base || !task->rs_base)
+  // Allocate independent stacks for task (or reuse the slot's previous ones)
+  if (!stack_reserve(vm, &task->ds_base, &task->ds_cap, ds_size) ||
+      !stack_reserve(vm, &task->rs_base, &task->rs_cap, rs_size))
   {
     // Cleanup on allocation failure
-    if (task->ds_base)
-      free(task->ds_base);
-    if (task->rs_base)
-      free(task->rs_base);
-    task->ds_base = nullptr;
-    task->rs_base = nullptr;
+    stack_release(vm, &task->rs_base, &task->rs_cap);
+    stack_release(vm, &task->ds_base, &task->ds_cap);
     return V4_ERR(NoMemory);
   }
 
@@ -145,17 +153,9 @@ extern "C" v4_err v4_backend_task_exit(Vm *vm)
   uint8_t task_id = vm->scheduler.current_task;
   v4_task_t *task = &vm->scheduler.tasks[task_id];
 
-  // Free task stacks
-  if (task->ds_base)
-  {
-    free(task->ds_base);
-    task->ds_base = nullptr;
-  }
-  if (task->rs_base)
-  {
-    free(task->rs_base);
-    task->rs_base = nullptr;
-  }
+  // Free task stacks; the arena free list takes them back out of order
+  stack_release(vm, &task->rs_base, &task->rs_cap);
+  stack_release(vm, &task->ds_base, &task->ds_cap);
 
   // Mark task as DEAD
   task->state = V4_TASK_STATE_DEAD;
@@ -0,0 +1,367 @@
+// src/text.cpp — byte search, scanning and number formatting kernels over VM memory
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "v4/errors.hpp"
+#ifndef V4_USE_V4STD
+#include "v4/hal.h"
+#endif
+#include "v4/internal/sys_kernels.hpp"
+
+/* ---- Helpers ---- */
+
+static inline v4_i32 offset_or_none(const uint8_t *base, const uint8_t *hit)
+{
+  return hit ? (v4_i32)(hit - base) : -1;
+}
+
+static inline bool is_space(uint8_t c)
+{
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static inline int hex_digit(uint8_t c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  c |= 0x20;  // fold to lower case
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  return -1;
+}
+
+/* ========================================================================= */
+/* Search                                                                    */
+/* ========================================================================= */
+
+/* ( addr len byte -- off|-1 ) */
+v4_err v4_k_find_byte(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  uint8_t *p;
+  if (v4_err e = v4_kernel_range(vm, in[0], in[1], &p))
+    return e;
+  out[0] = -1;
+  if (in[1] == 0)
+    return V4_ERR(OK);
+
+  // libc memchr is word-at-a-time or SIMD on every target we care about
+  out[0] = offset_or_none(p, (const uint8_t *)memchr(p, (uint8_t)in[2], (v4_u32)in[1]));
+  return V4_ERR(OK);
+}
+
+/* ( addr len set set_len -- off|-1 ) */
+v4_err v4_k_find_any(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  uint8_t *p, *set;
+  if (v4_err e = v4_kernel_range(vm, in[0], in[1], &p))
+    return e;
+  if (v4_err e = v4_kernel_range(vm, in[2], in[3], &set))
+    return e;
+  out[0] = -1;
+  const v4_u32 len = (v4_u32)in[1];
+  const v4_u32 set_len = (v4_u32)in[3];
+  if (len == 0 || set_len == 0)
+    return V4_ERR(OK);
+
+  if (set_len == 1)
+  {
+    out[0] = offset_or_none(p, (const uint8_t *)memchr(p, set[0], len));
+    return V4_ERR(OK);
+  }
+
+  // 256-bit membership bitmap: one load + test per scanned byte
+  uint32_t bits[8] = {};
+  for (v4_u32 i = 0; i < set_len; i++)
+    bits[set[i] >> 5] |= 1u << (set[i] & 31);
+
+  for (v4_u32 i = 0; i < len; i++)
+  {
+    const uint8_t c = p[i];
+    if (bits[c >> 5] & (1u << (c & 31)))
+    {
+      out[0] = (v4_i32)i;
+      break;
+    }
+  }
+  return V4_ERR(OK);
+}
+
+/* ( addr len pat pat_len -- off|-1 ) */
+v4_err v4_k_find_sub(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  uint8_t *p, *pat;
+  if (v4_err e = v4_kernel_range(vm, in[0], in[1], &p))
+    return e;
+  if (v4_err e = v4_kernel_range(vm, in[2], in[3], &pat))
+    return e;
+  const v4_u32 len = (v4_u32)in[1];
+  const v4_u32 pat_len = (v4_u32)in[3];
+
+  // Empty pattern matches at offset 0
+  out[0] = pat_len == 0 ? 0 : -1;
+  if (pat_len == 0 || pat_len > len)
+    return V4_ERR(OK);
+
+  // memchr on the first pattern byte, then verify the rest
+  const uint8_t *s = p;
+  const uint8_t *const last = p + (len - pat_len);
+  while (s <= last)
+  {
+    s = (const uint8_t *)memchr(s, pat[0], (size_t)(last - s) + 1);
+    if (!s)
+      break;
+    if (memcmp(s + 1, pat + 1, pat_len - 1) == 0)
+    {
+      out[0] = (v4_i32)(s - p);
+      break;
+    }
+    ++s;
+  }
+  return V4_ERR(OK);
+}
+
+/* ========================================================================= */
+/* Scanning and number parsing                                               */
+/* ========================================================================= */
+
+/* ( addr len -- off|-1 ): offset of first byte that is not a space/tab/CR/LF/VT/FF */
+v4_err v4_k_skip_ws(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  uint8_t *p;
+  if (v4_err e = v4_kernel_range(vm, in[0], in[1], &p))
+    return e;
+  const v4_u32 len = (v4_u32)in[1];
+  out[0] = -1;
+  for (v4_u32 i = 0; i < len; i++)
+  {
+    if (!is_space(p[i]))
+    {
+      out[0] = (v4_i32)i;
+      break;
+    }
+  }
+  return V4_ERR(OK);
+}
+
+/*
+ * ( addr len -- value count )
+ * Optional '+'/'-' sign followed by decimal digits. count is the number of
+ * bytes consumed, or -1 (value 0) if no digit was found. Accumulation wraps
+ * modulo 2^32.
+ */
+v4_err v4_k_parse_dec(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  uint8_t *p;
+  if (v4_err e = v4_kernel_range(vm, in[0], in[1], &p))
+    return e;
+  const v4_u32 len = (v4_u32)in[1];
+  out[0] = 0;
+  out[1] = -1;
+
+  v4_u32 i = 0;
+  bool neg = false;
+  if (i < len && (p[i] == '-' || p[i] == '+'))
+    neg = (p[i++] == '-');
+
+  const v4_u32 digits_start = i;
+  v4_u32 value = 0;
+  while (i < len && p[i] >= '0' && p[i] <= '9')
+    value = value * 10u + (v4_u32)(p[i++] - '0');
+
+  if (i == digits_start)
+    return V4_ERR(OK);
+
+  out[0] = (v4_i32)(neg ? 0u - value : value);
+  out[1] = (v4_i32)i;
+  return V4_ERR(OK);
+}
+
+/*
+ * ( addr len -- value count )
+ * Optional "0x"/"0X" prefix followed by hex digits (either case). count is
+ * the number of bytes consumed, or -1 (value 0) if no digit was found.
+ */
+v4_err v4_k_parse_hex(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  uint8_t *p;
+  if (v4_err e = v4_kernel_range(vm, in[0], in[1], &p))
+    return e;
+  const v4_u32 len = (v4_u32)in[1];
+  out[0] = 0;
+  out[1] = -1;
+
+  v4_u32 i = 0;
+  if (len >= 3 && p[0] == '0' && (p[1] | 0x20) == 'x' && hex_digit(p[2]) >= 0)
+    i = 2;
+
+  const v4_u32 digits_start = i;
+  v4_u32 value = 0;
+  int d;
+  while (i < len && (d = hex_digit(p[i])) >= 0)
+  {
+    value = (value << 4) | (v4_u32)d;
+    i++;
+  }
+
+  if (i == digits_start)
+    return V4_ERR(OK);
+
+  out[0] = (v4_i32)value;
+  out[1] = (v4_i32)i;
+  return V4_ERR(OK);
+}
+
+/* ========================================================================= */
+/* Number formatting                                                         */
+/* ========================================================================= */
+
+/* Longest rendering: "-2147483648" (11) or "-214748.3648" (12) */
+enum
+{
+  FMT_MAX = 16
+};
+
+static const char kDigitPairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const uint32_t kPow10[10] = {1u,      10u,      100u,      1000u,      10000u,
+                                    100000u, 1000000u, 10000000u, 100000000u, 1000000000u};
+
+/* Render v right-aligned so that it ends at `end`; returns the digit count.
+ * Emits two digits per division to halve the DIVU work. */
+static int put_udec(char *end, uint32_t v)
+{
+  char *p = end;
+  while (v >= 100)
+  {
+    const uint32_t r = (v % 100u) * 2u;
+    v /= 100u;
+    *--p = kDigitPairs[r + 1];
+    *--p = kDigitPairs[r];
+  }
+  if (v >= 10)
+  {
+    *--p = kDigitPairs[v * 2u + 1];
+    *--p = kDigitPairs[v * 2u];
+  }
+  else
+  {
+    *--p = (char)('0' + v);
+  }
+  return (int)(end - p);
+}
+
+/* Copy a rendered number into the ( addr cap ) buffer; len or -1 if it does not fit. */
+static v4_err store_text(Vm *vm, v4_i32 addr, v4_i32 cap, const char *s, int n,
+                         v4_i32 *out)
+{
+  uint8_t *p;
+  if (v4_err e = v4_kernel_range(vm, addr, cap, &p))
+    return e;
+  if ((v4_u32)cap < (v4_u32)n)
+  {
+    out[0] = -1;
+    return V4_ERR(OK);
+  }
+  v4_mem_note_write(vm, (v4_u32)addr, (v4_u32)n);
+  memcpy(p, s, (size_t)n);
+  out[0] = n;
+  return V4_ERR(OK);
+}
+
+/* ( n addr cap -- len ) */
+v4_err v4_k_fmt_dec(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  char buf[FMT_MAX];
+  char *const end = buf + sizeof(buf);
+  const bool neg = in[0] < 0;
+  const uint32_t mag = neg ? 0u - (uint32_t)in[0] : (uint32_t)in[0];
+  int n = put_udec(end, mag);
+  if (neg)
+    end[-++n] = '-';
+  return store_text(vm, in[1], in[2], end - n, n, out);
+}
+
+/* ( u addr cap -- len ) */
+v4_err v4_k_fmt_udec(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  char buf[FMT_MAX];
+  char *const end = buf + sizeof(buf);
+  const int n = put_udec(end, (uint32_t)in[0]);
+  return store_text(vm, in[1], in[2], end - n, n, out);
+}
+
+/*
+ * ( u width addr cap -- len )
+ * Upper-case hex, zero-padded to at least width digits (0..8; 0 and 1 both
+ * mean "no padding").
+ */
+v4_err v4_k_fmt_hex(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  static const char kHex[] = "0123456789ABCDEF";
+  if ((v4_u32)in[1] > 8)
+    return V4_ERR(InvalidArg);
+
+  char buf[FMT_MAX];
+  char *const end = buf + sizeof(buf);
+  uint32_t v = (uint32_t)in[0];
+  int n = 0;
+  do
+  {
+    end[-++n] = kHex[v & 0xFu];
+    v >>= 4;
+  } while (v);
+  while (n < in[1])
+    end[-++n] = '0';
+  return store_text(vm, in[2], in[3], end - n, n, out);
+}
+
+/*
+ * ( n frac addr cap -- len )
+ * Decimal fixed point: n is the value scaled by 10^frac (0..9), so
+ * 2345 2 renders as "23.45" and -5 2 as "-0.05".
+ */
+v4_err v4_k_fmt_fixed(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  if ((v4_u32)in[1] > 9)
+    return V4_ERR(InvalidArg);
+
+  char buf[FMT_MAX];
+  char *const end = buf + sizeof(buf);
+  const bool neg = in[0] < 0;
+  const uint32_t mag = neg ? 0u - (uint32_t)in[0] : (uint32_t)in[0];
+  const int frac = in[1];
+  int n = 0;
+  if (frac > 0)
+  {
+    uint32_t f = mag % kPow10[frac];
+    for (int i = 0; i < frac; i++, f /= 10u)
+      end[-++n] = (char)('0' + f % 10u);
+    end[-++n] = '.';
+  }
+  n += put_udec(end - n, mag / kPow10[frac]);
+  if (neg)
+    end[-++n] = '-';
+  return store_text(vm, in[2], in[3], end - n, n, out);
+}
+
+#ifndef V4_USE_V4STD
+/* ( addr len -- err ): one console write for the whole range */
+v4_err v4_k_type(Vm *vm, const v4_i32 *in, v4_i32 *out)
+{
+  uint8_t *p;
+  if (v4_err e = v4_kernel_range(vm, in[0], in[1], &p))
+    return e;
+  if (in[1] == 0)
+  {
+    out[0] = HAL_OK;
+    return V4_ERR(OK);
+  }
+  const int result = hal_console_write(p, (v4_u32)in[1]);
+  out[0] = (result == in[1]) ? HAL_OK : ((result < 0) ? result : HAL_ERR_IO);
+  return V4_ERR(OK);
+}
+#endif
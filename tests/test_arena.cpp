@@ -205,3 +205,99 @@ TEST_CASE("Arena with struct allocation")
   CHECK(s2->a == 100);
   CHECK(s1->a == 10);  // First struct unchanged
 }
+
+TEST_CASE("Arena mark and release")
+{
+  alignas(16) uint8_t buffer[256];
+  V4Arena arena;
+  v4_arena_init(&arena, buffer, sizeof(buffer));
+
+  void* keep = v4_arena_alloc(&arena, 40, 1);
+  REQUIRE(keep != nullptr);
+
+  V4ArenaMark outer = v4_arena_mark(&arena);
+  REQUIRE(v4_arena_alloc(&arena, 50, 1) != nullptr);
+  V4ArenaMark inner = v4_arena_mark(&arena);
+  REQUIRE(v4_arena_alloc(&arena, 60, 1) != nullptr);
+  CHECK(v4_arena_used(&arena) == 150);
+
+  v4_arena_release(&arena, inner);
+  CHECK(v4_arena_used(&arena) == 90);
+
+  // Space is reused from the mark on
+  void* again = v4_arena_alloc(&arena, 8, 1);
+  CHECK(again == buffer + 90);
+
+  v4_arena_release(&arena, outer);
+  CHECK(v4_arena_used(&arena) == 40);
+
+  // Releasing an already-released mark is a no-op
+  v4_arena_release(&arena, inner);
+  CHECK(v4_arena_used(&arena) == 40);
+}
+
+TEST_CASE("Arena chained growth")
+{
+  alignas(16) uint8_t buffer[64];
+  V4Arena arena;
+  v4_arena_init_chained(&arena, buffer, sizeof(buffer), 128);
+
+  void* a = v4_arena_alloc(&arena, 48, 1);
+  CHECK(a == buffer);
+  V4ArenaMark mark = v4_arena_mark(&arena);
+
+  // Does not fit the initial buffer: a chunk is appended
+  uint8_t* b = (uint8_t*)v4_arena_alloc(&arena, 32, 8);
+  REQUIRE(b != nullptr);
+  CHECK((b < buffer || b >= buffer + sizeof(buffer)));
+  CHECK(((uintptr_t)b & 7) == 0);
+  CHECK(v4_arena_used(&arena) == 80);
+
+  // Oversized requests get a chunk of their own
+  uint8_t* big = (uint8_t*)v4_arena_alloc(&arena, 1000, 64);
+  REQUIRE(big != nullptr);
+  CHECK(((uintptr_t)big & 63) == 0);
+  memset(big, 0x5A, 1000);
+  memset(b, 0x11, 32);
+  CHECK(big[999] == 0x5A);
+
+  // Release pops both chunks and returns to the initial buffer
+  v4_arena_release(&arena, mark);
+  CHECK(v4_arena_used(&arena) == 48);
+  CHECK(arena.buffer == buffer);
+  CHECK(arena.chunk == nullptr);
+
+  // The spare chunk is reused on the next growth
+  void* c = v4_arena_alloc(&arena, 100, 1);
+  REQUIRE(c != nullptr);
+  v4_arena_reset(&arena);
+  CHECK(v4_arena_used(&arena) == 0);
+
+  v4_arena_destroy(&arena);
+  CHECK(arena.spare == nullptr);
+
+  // Fixed arenas still refuse to grow
+  V4Arena fixed;
+  v4_arena_init(&fixed, buffer, sizeof(buffer));
+  CHECK(v4_arena_alloc(&fixed, 100, 1) == nullptr);
+}
+
+#ifndef V4_NO_MALLOC
+TEST_CASE("Thread-local arena")
+{
+  V4Arena* t = v4_arena_thread();
+  REQUIRE(t != nullptr);
+  CHECK(v4_arena_thread() == t);
+
+  V4ArenaMark m = v4_arena_mark(t);
+  for (int i = 0; i < 100; i++)
+    REQUIRE(v4_arena_alloc(t, 200, 8) != nullptr);
+  CHECK(v4_arena_used(t) >= 20000);
+  v4_arena_release(t, m);
+  CHECK(v4_arena_used(t) == 0);
+
+  v4_arena_thread_destroy();
+  CHECK(v4_arena_alloc(v4_arena_thread(), 16, 8) != nullptr);
+  v4_arena_thread_destroy();
+}
+#endif  // V4_NO_MALLOC
@@ -1,5 +1,6 @@
 #define DOCTEST_CONFIG_NO_EXCEPTIONS_BUT_WITH_ALL_ASSERTS
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <cstdio>
 #include <cstring>
 
 #include "doctest.h"
@@ -48,6 +49,8 @@ TEST_CASE("vm_register_word - basic registration")
   int idx = vm_register_word(&vm, nullptr, word_code, k);
   CHECK(idx == 0);  // First word should get index 0
   CHECK(vm.word_count == 1);
+
+  vm_reset_dictionary(&vm);
 }
 
 TEST_CASE("vm_register_word - multiple words")
@@ -84,6 +87,8 @@ TEST_CASE("vm_register_word - multiple words")
   CHECK(idx2 == 1);
   CHECK(idx3 == 2);
   CHECK(vm.word_count == 3);
+
+  vm_reset_dictionary(&vm);
 }
 
 TEST_CASE("vm_register_word - invalid arguments")
@@ -126,6 +131,231 @@ TEST_CASE("vm_register_word - dictionary full")
   int idx = vm_register_word(&vm, nullptr, word_code, k);
   CHECK(idx == static_cast<int>(Err::DictionaryFull));
   CHECK(vm.word_count == 256);
+
+  vm_reset_dictionary(&vm);
+}
+
+TEST_CASE("vm_register_word - configured capacity and growth")
+{
+  v4_u8 ret[1] = {(v4_u8)Op::RET};
+  VmConfig cfg{};
+
+  // Small fixed dictionary
+  cfg.dict_words = 4;
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+  CHECK(vm->word_cap == 0);  // nothing allocated until the first word
+  for (int i = 0; i < 4; i++)
+    CHECK(vm_register_word(vm, nullptr, ret, 1) == i);
+  CHECK(vm_register_word(vm, nullptr, ret, 1) == static_cast<int>(Err::DictionaryFull));
+  CHECK(vm->word_cap == 4);
+  vm_destroy(vm);
+
+  // Geometric growth beyond the default up to the limit
+  cfg.dict_words = 8;
+  cfg.dict_max_words = 1000;
+  vm = vm_create(&cfg);
+  REQUIRE(vm);
+  REQUIRE(vm_register_word(vm, "first", ret, 1) == 0);
+  Word* first = vm_get_word(vm, 0);
+
+  // EXECUTE word 0 before and after the dictionary grows
+  v4_u8 exec_code[2] = {(v4_u8)Op::EXECUTE, (v4_u8)Op::RET};
+  vm_ds_push(vm, 0);
+  REQUIRE(vm_exec_raw(vm, exec_code, 2) == 0);
+#ifdef V4_WORD_PROFILE
+  REQUIRE(vm_word_profile(vm, 1) == 0);  // counters follow the growth
+#endif
+
+  for (int i = 1; i < 1000; i++)
+    REQUIRE(vm_register_word(vm, nullptr, ret, 1) == i);
+  CHECK(vm->word_cap == 1000);
+  CHECK(vm_register_word(vm, nullptr, ret, 1) == static_cast<int>(Err::DictionaryFull));
+  CHECK(vm_find_word(vm, "first") == 0);
+  CHECK(vm_get_word(vm, 0) == first);  // segments never move
+  CHECK(vm_exec(vm, first) == 0);
+  vm_ds_push(vm, 0);
+  CHECK(vm_exec_raw(vm, exec_code, 2) == 0);
+  CHECK(vm_ds_depth_public(vm) == 0);
+
+  // CALL by index still reaches words added after growth
+  v4_u8 call_code[4];
+  int k = 0;
+  emit8(call_code, &k, (v4_u8)Op::CALL);
+  emit16(call_code, &k, 999);
+  emit8(call_code, &k, (v4_u8)Op::RET);
+  CHECK(vm_exec_raw(vm, call_code, k) == 0);
+#ifdef V4_WORD_PROFILE
+  CHECK(vm->word_calls_cap == 1000);
+  CHECK(vm_word_get_calls(vm, 999) == 1);
+  CHECK(vm_word_get_calls(vm, 0) == 1);
+#endif
+
+  // Forks get their own copy with room to keep growing
+  vm->dict_max = 2000;
+  Vm* child = vm_fork(vm);
+  REQUIRE(child);
+  CHECK(vm_register_word(child, nullptr, ret, 1) == 1000);
+  CHECK(child->word_cap == 1024);  // 8 + 8 + 16 + ... + 512
+  CHECK(vm->word_count == 1000);
+  vm_destroy(child);
+  vm_destroy(vm);
+
+  // Segments of an odd first size map every index to its own entry
+  cfg.dict_words = 3;
+  cfg.dict_max_words = 100;
+  vm = vm_create(&cfg);
+  REQUIRE(vm);
+  char name[8];
+  for (int i = 0; i < 100; i++)
+  {
+    snprintf(name, sizeof(name), "w%d", i);
+    REQUIRE(vm_register_word(vm, name, ret, 1) == i);
+  }
+  CHECK(vm->word_cap == 100);
+  for (int i = 0; i < 100; i++)
+  {
+    snprintf(name, sizeof(name), "w%d", i);
+    CHECK(strcmp(vm_word_get_name(vm_get_word(vm, i)), name) == 0);
+    CHECK(vm_find_word(vm, name) == i);
+  }
+  vm_destroy(vm);
+}
+
+TEST_CASE("vm_register_word - code arena copies bytecode")
+{
+  uint8_t ram[16] = {(v4_u8)Op::RET};
+  VmConfig cfg{};
+  cfg.mem = ram;
+  cfg.mem_size = sizeof(ram);
+  cfg.code_arena_size = 128;
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  // ADD10: LIT 10; ADD; RET — the caller's buffer is not used after registration
+  v4_u8 add10[8];
+  int k = 0;
+  emit8(add10, &k, (v4_u8)Op::LIT);
+  emit32(add10, &k, 10);
+  emit8(add10, &k, (v4_u8)Op::ADD);
+  emit8(add10, &k, (v4_u8)Op::RET);
+  REQUIRE(vm_register_word(vm, "ADD10", add10, k) == 0);
+  const Word* w = vm_get_word(vm, 0);
+  CHECK(w->code != add10);
+  CHECK(((uintptr_t)w->code & (V4_CODE_LINE - 1)) == 0);
+  CHECK(memcmp(w->code, add10, (size_t)k) == 0);
+  memset(add10, 0xFF, sizeof(add10));
+
+  v4_u8 main_code[8];
+  int mk = 0;
+  emit8(main_code, &mk, (v4_u8)Op::LIT_U8);
+  emit8(main_code, &mk, 5);
+  emit8(main_code, &mk, (v4_u8)Op::CALL);
+  emit16(main_code, &mk, 0);
+  emit8(main_code, &mk, (v4_u8)Op::RET);
+  REQUIRE(vm_exec_raw(vm, main_code, mk) == 0);
+  CHECK(vm_ds_peek_public(vm, 0) == 15);
+
+  // A word that fits in one line but would straddle two starts the next line
+  v4_u8 body[59];
+  for (int i = 0; i < 58; i += 2)
+  {
+    body[i] = (v4_u8)Op::LIT0;
+    body[i + 1] = (v4_u8)Op::DROP;
+  }
+  body[58] = (v4_u8)Op::RET;
+  REQUIRE(vm_register_word(vm, "BODY", body, sizeof(body)) == 1);
+  CHECK(vm_get_word(vm, 1)->code == vm->code_mem + V4_CODE_LINE);
+
+  // Arena exhausted
+  CHECK(vm_register_word(vm, "MORE", body, 10) == static_cast<int>(Err::NoMemory));
+  CHECK(vm->word_count == 2);
+
+  // Execute-in-place words are never copied
+  vm->last_err = 0;
+  REQUIRE(vm_register_word_at(vm, "XIP", 0, 1) == 2);
+  CHECK(vm_get_word(vm, 2)->code == ram);
+  vm_destroy(vm);
+}
+
+TEST_CASE("vm_relayout_words - call graph and profile order")
+{
+  VmConfig cfg{};
+  cfg.code_arena_size = 1024;
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  // 0 INC1, 1 COLD, 2 INC2, 3 MID (CALL 2, CALL 0), 4 MAIN (CALL 3)
+  const v4_u8 inc[] = {(v4_u8)Op::INC, (v4_u8)Op::RET};
+  const v4_u8 cold[] = {(v4_u8)Op::LIT0, (v4_u8)Op::DROP, (v4_u8)Op::RET};
+  const v4_u8 mid[] = {(v4_u8)Op::CALL, 2, 0, (v4_u8)Op::CALL, 0, 0, (v4_u8)Op::RET};
+  const v4_u8 top[] = {(v4_u8)Op::CALL, 3, 0, (v4_u8)Op::RET};
+  REQUIRE(vm_register_word(vm, "INC1", inc, sizeof(inc)) == 0);
+  REQUIRE(vm_register_word(vm, "COLD", cold, sizeof(cold)) == 1);
+  REQUIRE(vm_register_word(vm, "INC2", inc, sizeof(inc)) == 2);
+  REQUIRE(vm_register_word(vm, "MID", mid, sizeof(mid)) == 3);
+  REQUIRE(vm_register_word(vm, "MAIN", top, sizeof(top)) == 4);
+
+  auto at = [vm](int i) { return (int)(vm->words[i].code - vm->code_mem); };
+  const v4_u8 run[] = {(v4_u8)Op::LIT0, (v4_u8)Op::CALL, 4, 0, (v4_u8)Op::RET};
+  auto result = [vm, &run]()
+  {
+    vm_reset_stacks(vm);
+    if (vm_exec_raw(vm, run, sizeof(run)) != 0)
+      return -1;
+    return (int)vm_ds_peek_public(vm, 0);
+  };
+
+  // No profile: MAIN, MID and its callees in site order, then the other root
+  CHECK(vm_relayout_words(vm, nullptr, 0) == 0);
+  CHECK(at(4) == 0);
+  CHECK(at(3) == 4);
+  CHECK(at(2) == 11);
+  CHECK(at(0) == 13);
+  CHECK(at(1) == 15);
+  CHECK(vm->code_used == 18);
+  CHECK(result() == 2);
+
+  // Given profile: hottest first, never-called words last
+  const v4_u32 calls[] = {9, 0, 1, 1, 1};
+  CHECK(vm_relayout_words(vm, calls, 5) == 0);
+  CHECK(at(0) == 0);
+  CHECK(at(2) == 2);
+  CHECK(at(3) == 4);
+  CHECK(at(4) == 11);
+  CHECK(at(1) == 15);
+  CHECK(result() == 2);
+
+  // Recorded profile
+#ifdef V4_WORD_PROFILE
+  CHECK(vm_word_profile(vm, 1) == 0);
+  CHECK(result() == 2);
+  CHECK(result() == 2);
+  CHECK(vm_word_profile(vm, 0) == 0);
+  CHECK(result() == 2);
+  CHECK(vm_word_get_calls(vm, 0) == 2);
+  CHECK(vm_word_get_calls(vm, 4) == 2);
+  CHECK(vm_word_get_calls(vm, 1) == 0);
+  CHECK(vm_word_get_calls(vm, 5) == 0);
+  CHECK(vm_relayout_words(vm, nullptr, 0) == 0);
+  CHECK(at(1) == 15);
+  CHECK(result() == 2);
+#else
+  CHECK(vm_word_profile(vm, 1) == static_cast<int>(Err::InvalidArg));
+  CHECK(vm_word_get_calls(vm, 0) == 0);
+#endif
+
+  // Forks run the arena in place: no relayout while one is alive
+  Vm* fork = vm_fork(vm);
+  REQUIRE(fork);
+  const int before = at(0);
+  CHECK(vm_relayout_words(vm, nullptr, 0) == static_cast<int>(Err::InvalidArg));
+  CHECK(at(0) == before);
+  vm_destroy(fork);
+  CHECK(vm_relayout_words(vm, nullptr, 0) == 0);
+
+  CHECK(vm_relayout_words(vm, nullptr, 3) == static_cast<int>(Err::InvalidArg));
+  vm_destroy(vm);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -149,6 +379,8 @@ TEST_CASE("vm_get_word - retrieve registered word")
   REQUIRE(word != nullptr);
   CHECK(word->code == word_code);
   CHECK(word->code_len == k);
+
+  vm_reset_dictionary(&vm);
 }
 
 TEST_CASE("vm_get_word - invalid index")
@@ -173,6 +405,8 @@ TEST_CASE("vm_get_word - invalid index")
   // Invalid indices
   CHECK(vm_get_word(&vm, 1) == nullptr);
   CHECK(vm_get_word(&vm, -1) == nullptr);
+
+  vm_reset_dictionary(&vm);
 }
 
 TEST_CASE("vm_get_word - NULL vm")
@@ -209,6 +443,8 @@ TEST_CASE("CALL instruction - basic word call")
   CHECK(rc == 0);
   CHECK(vm.sp == vm.DS + 1);
   CHECK(vm.DS[0] == 42);
+
+  vm_reset_dictionary(&vm);
 }
 
 TEST_CASE("CALL instruction - word with arithmetic")
@@ -239,6 +475,8 @@ TEST_CASE("CALL instruction - word with arithmetic")
   CHECK(rc == 0);
   CHECK(vm.sp == vm.DS + 1);
   CHECK(vm.DS[0] == 42);
+
+  vm_reset_dictionary(&vm);
 }
 
 TEST_CASE("CALL instruction - multiple calls")
@@ -275,6 +513,8 @@ TEST_CASE("CALL instruction - multiple calls")
   CHECK(rc == 0);
   CHECK(vm.sp == vm.DS + 1);
   CHECK(vm.DS[0] == 35);
+
+  vm_reset_dictionary(&vm);
 }
 
 TEST_CASE("CALL instruction - calling multiple different words")
@@ -318,6 +558,8 @@ TEST_CASE("CALL instruction - calling multiple different words")
   CHECK(rc == 0);
   CHECK(vm.sp == vm.DS + 1);
   CHECK(vm.DS[0] == 26);
+
+  vm_reset_dictionary(&vm);
 }
 
 TEST_CASE("CALL instruction - nested calls")
@@ -364,6 +606,8 @@ TEST_CASE("CALL instruction - nested calls")
   CHECK(rc == 0);
   CHECK(vm.sp == vm.DS + 1);
   CHECK(vm.DS[0] == 25);
+
+  vm_reset_dictionary(&vm);
 }
 
 TEST_CASE("CALL instruction - invalid word index")
@@ -404,6 +648,49 @@ TEST_CASE("CALL instruction - out of bounds word index")
 
   int rc = vm_exec_raw(&vm, main_code, mk);
   CHECK(rc == static_cast<int>(Err::InvalidWordIdx));
+
+  vm_reset_dictionary(&vm);
+}
+
+TEST_CASE("CALL instruction - dictionary past 65536 words")
+{
+  v4_u8 ret[1] = {(v4_u8)Op::RET};
+  v4_u8 lit1[6], lit2[6];
+  int k1 = 0, k2 = 0;
+  emit8(lit1, &k1, (v4_u8)Op::LIT);
+  emit32(lit1, &k1, 1);
+  emit8(lit1, &k1, (v4_u8)Op::RET);
+  emit8(lit2, &k2, (v4_u8)Op::LIT);
+  emit32(lit2, &k2, 2);
+  emit8(lit2, &k2, (v4_u8)Op::RET);
+
+  VmConfig cfg{};
+  cfg.dict_max_words = 70000;
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+  REQUIRE(vm_register_word(vm, nullptr, lit1, k1) == 0);
+  for (int i = 1; i < 65600; i++)
+  {
+    const int idx = i == 65535 ? vm_register_word(vm, nullptr, lit2, k2)
+                               : vm_register_word(vm, nullptr, ret, 1);
+    REQUIRE(idx == i);
+  }
+  REQUIRE(vm->word_count > 65536);
+
+  // CALL 0; CALL 65535; RET
+  v4_u8 main_code[8];
+  int mk = 0;
+  emit8(main_code, &mk, (v4_u8)Op::CALL);
+  emit16(main_code, &mk, 0);
+  emit8(main_code, &mk, (v4_u8)Op::CALL);
+  emit16(main_code, &mk, 65535);
+  emit8(main_code, &mk, (v4_u8)Op::RET);
+
+  CHECK(vm_exec_raw(vm, main_code, mk) == 0);
+  CHECK(vm_ds_depth_public(vm) == 2);
+  CHECK(vm_ds_peek_public(vm, 1) == 1);
+  CHECK(vm_ds_peek_public(vm, 0) == 2);
+  vm_destroy(vm);
 }
 
 TEST_CASE("CALL instruction - truncated instruction")
@@ -425,6 +712,91 @@ TEST_CASE("CALL instruction - truncated instruction")
 
   int rc = vm_exec_raw(&vm, main_code, mk);
   CHECK(rc == static_cast<int>(Err::TruncatedJump));
+
+  vm_reset_dictionary(&vm);
+}
+
+/* ------------------------------------------------------------------------- */
+/* EXECUTE (indirect call) tests                                             */
+/* ------------------------------------------------------------------------- */
+TEST_CASE("EXECUTE instruction - call word index from stack")
+{
+  Vm vm{};
+  vm_reset(&vm);
+
+  // Word 0: LIT 10; ADD; RET   Word 1: LIT 20; ADD; RET
+  v4_u8 w0[16], w1[16];
+  int k0 = 0, k1 = 0;
+  emit8(w0, &k0, (v4_u8)Op::LIT);
+  emit32(w0, &k0, 10);
+  emit8(w0, &k0, (v4_u8)Op::ADD);
+  emit8(w0, &k0, (v4_u8)Op::RET);
+  emit8(w1, &k1, (v4_u8)Op::LIT);
+  emit32(w1, &k1, 20);
+  emit8(w1, &k1, (v4_u8)Op::ADD);
+  emit8(w1, &k1, (v4_u8)Op::RET);
+  REQUIRE(vm_register_word(&vm, nullptr, w0, k0) == 0);
+  REQUIRE(vm_register_word(&vm, nullptr, w1, k1) == 1);
+
+  // acc idx EXECUTE: the same site sees a monomorphic then a new target
+  v4_u8 main_code[8];
+  int mk = 0;
+  emit8(main_code, &mk, (v4_u8)Op::EXECUTE);
+  emit8(main_code, &mk, (v4_u8)Op::RET);
+
+  const int targets[] = {0, 0, 0, 1, 1, 0};
+  v4_i32 expect = 0;
+  vm_ds_push(&vm, 0);
+  for (int t : targets)
+  {
+    vm_ds_push(&vm, t);
+    CHECK(vm_exec_raw(&vm, main_code, mk) == 0);
+    expect += t ? 20 : 10;
+  }
+  CHECK(vm_ds_depth_public(&vm) == 1);
+  CHECK(vm_ds_peek_public(&vm, 0) == expect);
+
+  vm_reset_dictionary(&vm);
+}
+
+TEST_CASE("EXECUTE instruction - invalid index and dictionary reset")
+{
+  Vm vm{};
+  vm_reset(&vm);
+
+  v4_u8 word_code[16];
+  int wk = 0;
+  emit8(word_code, &wk, (v4_u8)Op::LIT);
+  emit32(word_code, &wk, 42);
+  emit8(word_code, &wk, (v4_u8)Op::RET);
+  vm_register_word(&vm, nullptr, word_code, wk);
+  vm_register_word(&vm, nullptr, word_code, wk);
+
+  v4_u8 main_code[8];
+  int mk = 0;
+  emit8(main_code, &mk, (v4_u8)Op::EXECUTE);
+  emit8(main_code, &mk, (v4_u8)Op::RET);
+
+  vm_ds_push(&vm, -1);
+  CHECK(vm_exec_raw(&vm, main_code, mk) == static_cast<int>(Err::InvalidWordIdx));
+
+  // Run index 1, then drop the dictionary: the index is re-checked
+  // against the new word count.
+  vm_reset_stacks(&vm);
+  vm_ds_push(&vm, 1);
+  CHECK(vm_exec_raw(&vm, main_code, mk) == 0);
+  CHECK(vm_ds_peek_public(&vm, 0) == 42);
+
+  vm_reset(&vm);
+  vm_register_word(&vm, nullptr, word_code, wk);
+  vm_ds_push(&vm, 1);
+  CHECK(vm_exec_raw(&vm, main_code, mk) == static_cast<int>(Err::InvalidWordIdx));
+
+  // Empty stack
+  vm_reset_stacks(&vm);
+  CHECK(vm_exec_raw(&vm, main_code, mk) == static_cast<int>(Err::StackUnderflow));
+
+  vm_reset_dictionary(&vm);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -538,6 +910,8 @@ TEST_CASE("vm_exec - word calling other words")
   CHECK(rc == 0);
   CHECK(vm.sp == vm.DS + 1);
   CHECK(vm.DS[0] == 25);
+
+  vm_reset_dictionary(&vm);
 }
 
 TEST_CASE("vm_reset clears word dictionary")
@@ -575,8 +949,8 @@ TEST_CASE("vm_register_word - named word")
 
   int idx = vm_register_word(&vm, "TEST", code, k);
   REQUIRE(idx >= 0);
-  REQUIRE(vm.words[idx].name != nullptr);
-  CHECK(strcmp(vm.words[idx].name, "TEST") == 0);
+  REQUIRE(vm_word_get_name(vm_get_word(&vm, idx)) != nullptr);
+  CHECK(strcmp(vm_word_get_name(vm_get_word(&vm, idx)), "TEST") == 0);
 
   vm_reset(&vm);  // Free allocated name
 }
@@ -592,7 +966,9 @@ TEST_CASE("vm_register_word - anonymous word (NULL name)")
 
   int idx = vm_register_word(&vm, nullptr, code, k);
   REQUIRE(idx >= 0);
-  CHECK(vm.words[idx].name == nullptr);
+  CHECK(vm_word_get_name(vm_get_word(&vm, idx)) == nullptr);
+
+  vm_reset_dictionary(&vm);
 }
 
 TEST_CASE("vm_register_word - multiple named words")
@@ -615,13 +991,13 @@ TEST_CASE("vm_register_word - multiple named words")
   REQUIRE(idx2 >= 0);
   REQUIRE(idx3 >= 0);
 
-  CHECK(vm.words[idx1].name != nullptr);
-  CHECK(strcmp(vm.words[idx1].name, "DOUBLE") == 0);
+  CHECK(vm_word_get_name(vm_get_word(&vm, idx1)) != nullptr);
+  CHECK(strcmp(vm_word_get_name(vm_get_word(&vm, idx1)), "DOUBLE") == 0);
 
-  CHECK(vm.words[idx2].name != nullptr);
-  CHECK(strcmp(vm.words[idx2].name, "SQUARE") == 0);
+  CHECK(vm_word_get_name(vm_get_word(&vm, idx2)) != nullptr);
+  CHECK(strcmp(vm_word_get_name(vm_get_word(&vm, idx2)), "SQUARE") == 0);
 
-  CHECK(vm.words[idx3].name == nullptr);
+  CHECK(vm_word_get_name(vm_get_word(&vm, idx3)) == nullptr);
 
   vm_reset(&vm);  // Free allocated names
 }
@@ -661,12 +1037,12 @@ TEST_CASE("vm_register_word - name is copied (strdup)")
 
   int idx = vm_register_word(&vm, name_buffer, code, k);
   REQUIRE(idx >= 0);
-  REQUIRE(vm.words[idx].name != nullptr);
-  CHECK(strcmp(vm.words[idx].name, "ORIGINAL") == 0);
+  REQUIRE(vm_word_get_name(vm_get_word(&vm, idx)) != nullptr);
+  CHECK(strcmp(vm_word_get_name(vm_get_word(&vm, idx)), "ORIGINAL") == 0);
 
   // Modify the original buffer - word name should be unchanged
   strcpy(name_buffer, "MODIFIED");
-  CHECK(strcmp(vm.words[idx].name, "ORIGINAL") == 0);
+  CHECK(strcmp(vm_word_get_name(vm_get_word(&vm, idx)), "ORIGINAL") == 0);
 
   vm_reset(&vm);  // Free allocated name
 }
@@ -686,8 +1062,8 @@ TEST_CASE("CALL instruction - named word execution")
 
   int word_idx = vm_register_word(&vm, "ADD10", word_code, wk);
   REQUIRE(word_idx >= 0);
-  REQUIRE(vm.words[word_idx].name != nullptr);
-  CHECK(strcmp(vm.words[word_idx].name, "ADD10") == 0);
+  REQUIRE(vm_word_get_name(vm_get_word(&vm, word_idx)) != nullptr);
+  CHECK(strcmp(vm_word_get_name(vm_get_word(&vm, word_idx)), "ADD10") == 0);
 
   // Main code: LIT 5; CALL 0; RET
   v4_u8 main_code[32];
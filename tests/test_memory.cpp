@@ -1,8 +1,16 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <signal.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "doctest.h"
+#include "v4/internal/guard_mem.hpp"
+#include "v4/internal/mem_file.hpp"
+#include "v4/internal/memory.hpp"
+#include "v4/internal/paged_mem.hpp"
 #include "v4/internal/vm.h"
+#include "v4/opcodes.hpp"
 #include "v4/vm_api.h"
 
 /* ------------------------------------------------------------------------- */
@@ -164,6 +172,305 @@ TEST_CASE("Mixed RAM/MMIO access")
   vm_destroy(vm);
 }
 
+/**
+ * @test More windows than the old fixed table held, registered out of
+ *       address order, with RAM accesses in the gaps between them.
+ */
+TEST_CASE("MMIO decode table with many windows")
+{
+  uint8_t ram[0x1000] = {};
+  Dummy dummy[40]{};
+  V4_Mmio m[40];
+  for (int i = 0; i < 40; ++i)
+  {
+    const int slot = (i * 7) % 40;  // scrambled registration order
+    m[i] = V4_Mmio{0x2000u + (v4_u32)slot * 0x100u, 0x40u, d_read32, d_write32,
+                   &dummy[slot]};
+  }
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), m, 20};
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+  CHECK(vm_register_mmio(vm, m + 20, 20) == 0);
+  CHECK(vm->mmio_count == 40);
+
+  for (int slot = 0; slot < 40; ++slot)
+  {
+    const v4_u32 addr = 0x2000u + (v4_u32)slot * 0x100u + 0x3Cu;
+    CHECK(vm_mem_write32(vm, addr, (v4_u32)slot) == 0);
+    CHECK(dummy[slot].last_write_addr == addr);
+    CHECK(dummy[slot].last_write_val == (v4_u32)slot);
+  }
+
+  // Gap between two windows (and past RAM) is neither MMIO nor RAM
+  v4_u32 out = 0;
+  CHECK(vm_mem_read32(vm, 0x2040u, &out) == -13);
+
+  // Plain RAM below the MMIO span
+  CHECK(vm_mem_write32(vm, 0x100u, 0x55AA55AAu) == 0);
+  CHECK(vm_mem_read32(vm, 0x100u, &out) == 0);
+  CHECK(out == 0x55AA55AAu);
+
+  vm_destroy(vm);
+}
+
+/**
+ * @test Overlapping windows resolve to the first registered one, and a
+ *       window shadows the RAM underneath it.
+ */
+TEST_CASE("MMIO overlap priority and RAM shadowing")
+{
+  uint8_t ram[64] = {};
+  Dummy a{}, b{};
+  V4_Mmio m[2] = {
+      {0x10u, 0x08u, d_read32, d_write32, &a},  // [0x10, 0x18)
+      {0x08u, 0x20u, d_read32, d_write32, &b},  // [0x08, 0x28), under a
+  };
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), m, 2};
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  CHECK(vm_mem_write32(vm, 0x08u, 1) == 0);
+  CHECK(b.last_write_val == 1);
+  CHECK(vm_mem_write32(vm, 0x14u, 2) == 0);
+  CHECK(a.last_write_val == 2);
+  CHECK(vm_mem_write32(vm, 0x24u, 3) == 0);
+  CHECK(b.last_write_val == 3);
+
+  // RAM under the windows is untouched; RAM above them still works
+  CHECK(ram[0x08] == 0);
+  CHECK(vm_mem_write32(vm, 0x28u, 4) == 0);
+  CHECK(ram[0x28] == 4);
+
+  vm_destroy(vm);
+}
+
+/**
+ * @test A window inside RAM and one above it do not send the RAM between them
+ *       through the decode table, and both windows still decode.
+ */
+TEST_CASE("Windows bracketing RAM keep RAM off the decode table")
+{
+  const v4_u32 page = 1u << V4_DECODE_PAGE_SHIFT;
+  static uint8_t ram[4u << V4_DECODE_PAGE_SHIFT];
+  memset(ram, 0, sizeof(ram));
+  Dummy lo{}, hi{};
+  V4_Mmio m[2] = {
+      {0x10u, 0x10u, d_read32, d_write32, &lo},         // shadows page 0
+      {0xF0000000u, 0x100u, d_read32, d_write32, &hi},  // far above RAM
+  };
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), m, 2};
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  // Only page 0 is marked; the hull starts above RAM
+  REQUIRE(vm->decode_shadow);
+  CHECK(vm->decode_pages == 4);
+  CHECK(vm->decode_shadow[0] == 1u);
+  CHECK(vm->decode_lo == 0xF0000000u);
+
+  CHECK(vm_mem_write32(vm, 0x14u, 1) == 0);
+  CHECK(lo.last_write_val == 1);
+  CHECK(vm_mem_write32(vm, 0xF0000010u, 2) == 0);
+  CHECK(hi.last_write_val == 2);
+
+  // RAM on page 0 beside the window, and on the pages after it
+  v4_u32 out = 0;
+  CHECK(vm_mem_write32(vm, 0x20u, 3) == 0);
+  CHECK(ram[0x20] == 3);
+  CHECK(vm_mem_write32(vm, 2 * page + 8, 4) == 0);
+  CHECK(vm_mem_read32(vm, 2 * page + 8, &out) == 0);
+  CHECK(out == 4);
+  CHECK(vm_mem_write32(vm, 4 * page - 4, 5) == 0);
+  CHECK(ram[4 * page - 4] == 5);
+  CHECK(vm_mem_write32(vm, 4 * page, 6) == -13);  // OobMemory
+
+  // A fork carries the same map
+  Vm *child = vm_fork(vm);
+  REQUIRE(child);
+  CHECK(child->decode_shadow != vm->decode_shadow);
+  CHECK(child->decode_shadow[0] == 1u);
+  CHECK(vm_mem_write32(child, 0x14u, 7) == 0);
+  CHECK(lo.last_write_val == 7);
+  CHECK(vm_mem_read32(child, 2 * page + 8, &out) == 0);
+  CHECK(out == 4);
+  vm_destroy(child);
+
+  vm_destroy(vm);
+}
+
+/**
+ * @test Direct windows are served from their host buffer at 8/16/32 bits,
+ *       honour their access flags, and keep MMIO priority over regions.
+ */
+TEST_CASE("Direct-pointer MMIO window without callbacks")
+{
+  uint8_t ram[64] = {};
+  uint8_t telemetry[32] = {};
+  uint8_t status[8] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+  static const uint8_t rom[16] = {};
+  V4_Mmio m[2] = {
+      {0x4000u, sizeof(telemetry), nullptr, nullptr, nullptr, telemetry,
+       V4_REGION_READ | V4_REGION_WRITE},
+      {0x5000u, sizeof(status), nullptr, nullptr, nullptr, status, V4_REGION_READ},
+  };
+  V4_Region under = {0x5000u, sizeof(rom), rom, V4_REGION_READ};
+  VmConfig cfg{ram, sizeof(ram), m, 2, nullptr, V4_MEM_CHECKED, &under, 1};
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  CHECK(vm_mem_write32(vm, 0x4004u, 0xA1B2C3D4u) == 0);
+  CHECK(telemetry[4] == 0xD4);
+  CHECK(telemetry[7] == 0xA1);
+  CHECK(v4_mem_write8_core(vm, 0x4010u, 0x5A) == 0);
+  CHECK(v4_mem_write16_core(vm, 0x4011u, 0xBEEF) == 0);
+  CHECK(telemetry[16] == 0x5A);
+  CHECK(telemetry[17] == 0xEF);
+  CHECK(telemetry[18] == 0xBE);
+
+  // Read-only window shadows the region underneath
+  v4_u32 out = 0;
+  CHECK(vm_mem_read32(vm, 0x5004u, &out) == 0);
+  CHECK(out == 0x88776655u);
+  CHECK(v4_mem_read16_core(vm, 0x5001u, &out) == 0);
+  CHECK(out == 0x3322u);
+  CHECK(vm_mem_write32(vm, 0x5000u, 0) == -13);
+  CHECK(v4_mem_write8_core(vm, 0x5000u, 0) == -13);
+  CHECK(vm_mem_read32(vm, 0x5008u, &out) == 0);  // region beyond the window
+
+  // Accesses may not run off the window; 32-bit keeps the alignment rule
+  CHECK(vm_mem_read32(vm, 0x401Eu, &out) == -12);
+  CHECK(v4_mem_read16_core(vm, 0x401Fu, &out) == -13);
+
+  // Bulk API and views see direct windows like RAM
+  CHECK(vm_mem_view(vm, 0x4000u, sizeof(telemetry), 1) == telemetry);
+
+  vm_destroy(vm);
+}
+
+/**
+ * A byte-oriented FIFO device: 8/16-bit registers plus burst callbacks.
+ */
+struct Fifo
+{
+  uint8_t data[64] = {};
+  v4_u32 head = 0;
+  int calls = 0;
+};
+
+static v4_err f_read8(void *user, v4_u32 addr, v4_u8 *out)
+{
+  Fifo *f = (Fifo *)user;
+  f->calls++;
+  *out = (v4_u8)(addr & 0xFF);
+  return 0;
+}
+
+static v4_err f_write8(void *user, v4_u32 addr, v4_u8 val)
+{
+  Fifo *f = (Fifo *)user;
+  (void)addr;
+  f->calls++;
+  f->data[f->head++ % sizeof(f->data)] = val;
+  return 0;
+}
+
+static v4_err f_read16(void *user, v4_u32 addr, v4_u16 *out)
+{
+  Fifo *f = (Fifo *)user;
+  f->calls++;
+  *out = (v4_u16)(0x1000u + (addr & 0xFF));
+  return 0;
+}
+
+static v4_err f_write16(void *user, v4_u32 addr, v4_u16 val)
+{
+  (void)addr;
+  f_write8(user, 0, (v4_u8)(val & 0xFF));
+  return f_write8(user, 0, (v4_u8)(val >> 8));
+}
+
+static v4_err f_write_block(void *user, v4_u32 addr, const void *src, v4_u32 len)
+{
+  Fifo *f = (Fifo *)user;
+  (void)addr;
+  f->calls++;
+  for (v4_u32 i = 0; i < len; i++)
+    f->data[f->head++ % sizeof(f->data)] = ((const uint8_t *)src)[i];
+  return 0;
+}
+
+/**
+ * @test 8/16-bit accesses reach the narrow callbacks (or fail when absent);
+ *       block transfers use one burst call, else fall back per byte.
+ */
+TEST_CASE("8/16-bit and burst MMIO callbacks")
+{
+  uint8_t ram[64] = {};
+  Fifo fifo;
+  Dummy dev;
+  V4_Mmio m[2] = {};
+  m[0].base = 0x3000u;
+  m[0].size = 0x100u;
+  m[0].user = &fifo;
+  m[0].read8 = f_read8;
+  m[0].write8 = f_write8;
+  m[0].read16 = f_read16;
+  m[0].write16 = f_write16;
+  m[0].write_block = f_write_block;
+  m[1] = V4_Mmio{0x20u, 0x10u, d_read32, d_write32, &dev};  // 32-bit only, over RAM
+  VmConfig cfg{ram, sizeof(ram), m, 2};
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  v4_u32 out = 0;
+  CHECK(v4_mem_read8_core(vm, 0x3007u, &out) == 0);
+  CHECK(out == 0x07u);
+  CHECK(v4_mem_read16_core(vm, 0x3011u, &out) == 0);
+  CHECK(out == 0x1011u);
+  CHECK(v4_mem_write8_core(vm, 0x3000u, 0xAB) == 0);
+  CHECK(v4_mem_write16_core(vm, 0x3000u, 0xCDEF) == 0);
+  CHECK(fifo.head == 3);
+  CHECK(fifo.data[1] == 0xEF);
+  CHECK(fifo.data[2] == 0xCD);
+
+  // A 16-bit access must not run past the window end
+  fifo.calls = 0;
+  CHECK(v4_mem_read16_core(vm, 0x30FEu, &out) == 0);
+  CHECK(out == 0x10FEu);
+  CHECK(v4_mem_read16_core(vm, 0x30FFu, &out) == -13);
+  CHECK(v4_mem_write16_core(vm, 0x30FFu, 0x1234) == -13);
+  CHECK(fifo.calls == 1);
+  CHECK(fifo.head == 3);
+
+  // Narrow access to a 32-bit-only window is refused, not sent to RAM
+  CHECK(v4_mem_read8_core(vm, 0x20u, &out) == -13);
+  CHECK(v4_mem_write16_core(vm, 0x22u, 1) == -13);
+  CHECK(ram[0x22] == 0);
+
+  // One burst call per transfer
+  const uint8_t frame[40] = {1, 2, 3};
+  fifo.calls = 0;
+  CHECK(vm_mem_write_block(vm, 0x3000u, frame, sizeof(frame)) == 0);
+  CHECK(fifo.calls == 1);
+  CHECK(fifo.head == 43);
+
+  // No read_block: falls back to read8 per byte
+  uint8_t in[5] = {};
+  fifo.calls = 0;
+  CHECK(vm_mem_read_block(vm, 0x3010u, in, sizeof(in)) == 0);
+  CHECK(fifo.calls == 5);
+  CHECK(in[4] == 0x14);
+
+  // 32-bit-only window: aligned transfers go cell by cell
+  uint8_t cells[8] = {};
+  CHECK(vm_mem_read_block(vm, 0x20u, cells, sizeof(cells)) == 0);
+  CHECK(cells[0] == 0xDD);
+  CHECK(cells[4] == 0xE1);
+  CHECK(vm_mem_read_block(vm, 0x21u, cells, 4) == -13);
+
+  vm_destroy(vm);
+}
+
 /* ------------------------------------------------------------------------- */
 /* Extended memory access operations (Commit 2)                              */
 /* ------------------------------------------------------------------------- */
@@ -270,3 +577,832 @@ TEST_CASE("16-bit signed load (LOAD16S)")
 
   vm_destroy(vm);
 }
+
+/* ------------------------------------------------------------------------- */
+/* Masked-address sandbox mode (V4_MEM_MASKED)                               */
+/* ------------------------------------------------------------------------- */
+TEST_CASE("V4_MEM_MASKED wraps addresses instead of failing")
+{
+  uint8_t ram[64 + V4_MEM_GUARD_BYTES] = {};
+  VmConfig cfg{ram, 64u, nullptr, 0, nullptr, V4_MEM_MASKED};
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  // 0x1000 + 8 aliases 8
+  CHECK(vm_mem_write32(vm, 0x1008u, 0xA1B2C3D4u) == 0);
+  v4_u32 out = 0;
+  CHECK(vm_mem_read32(vm, 8u, &out) == 0);
+  CHECK(out == 0xA1B2C3D4u);
+
+  // Alignment is still enforced for 32-bit access
+  CHECK(vm_mem_read32(vm, 0x1002u, &out) == -12);
+
+  // Byte and half-word access never fail; the last byte spills into the guard
+  CHECK(v4_mem_write8_core(vm, 0xFFFFFFFFu, 0x5A) == 0);
+  CHECK(ram[63] == 0x5A);
+  CHECK(v4_mem_write16_core(vm, 63u + 64u, 0xBEEF) == 0);
+  CHECK(ram[63] == 0xEF);
+  CHECK(ram[64] == 0xBE);
+  CHECK(v4_mem_read16_core(vm, 63u, &out) == 0);
+  CHECK(out == 0xBEEFu);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("V4_MEM_MASKED keeps MMIO windows above RAM")
+{
+  uint8_t ram[64 + V4_MEM_GUARD_BYTES] = {};
+  Dummy dummy{};
+  V4_Mmio m{0x100u, 0x10u, d_read32, d_write32, &dummy};
+  VmConfig cfg{ram, 64u, &m, 1, nullptr, V4_MEM_MASKED};
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  // Window is decoded before masking
+  CHECK(vm_mem_write32(vm, 0x104u, 0x1234u) == 0);
+  CHECK(dummy.last_write_val == 0x1234u);
+  CHECK(ram[4] == 0);
+
+  // Next to the window the address wraps into RAM (0x110 & 63 == 16)
+  CHECK(vm_mem_write32(vm, 0x110u, 0x77u) == 0);
+  CHECK(ram[16] == 0x77);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("V4_MEM_MASKED requires power-of-two RAM")
+{
+  uint8_t ram[48 + V4_MEM_GUARD_BYTES] = {};
+  VmConfig bad{ram, 48u, nullptr, 0, nullptr, V4_MEM_MASKED};
+  CHECK(vm_create(&bad) == nullptr);
+
+  VmConfig none{nullptr, 64u, nullptr, 0, nullptr, V4_MEM_MASKED};
+  CHECK(vm_create(&none) == nullptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Extra memory regions (ROM / RAM banks)                                    */
+/* ------------------------------------------------------------------------- */
+static const uint8_t kRomTable[16] = {0x01, 0x02, 0x03, 0x04, 0x10, 0x20, 0x30, 0x40,
+                                      0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x11, 0x22};
+
+TEST_CASE("Read-only region is served zero-copy and rejects stores")
+{
+  uint8_t ram[32] = {};
+  uint8_t bank[16] = {};
+  const V4_Region regions[] = {
+      {0x10000000u, sizeof(kRomTable), kRomTable, V4_REGION_READ},
+      {0x20000000u, sizeof(bank), bank, V4_REGION_READ | V4_REGION_WRITE},
+  };
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), nullptr, 0, nullptr, V4_MEM_CHECKED, regions, 2};
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  v4_u32 out = 0;
+  CHECK(vm_mem_read32(vm, 0x10000004u, &out) == 0);
+  CHECK(out == 0x40302010u);
+  CHECK(v4_mem_read8_core(vm, 0x1000000Bu, &out) == 0);
+  CHECK(out == 0xDDu);
+  CHECK(v4_mem_read16_core(vm, 0x1000000Fu, &out) == -13);  // runs past the end
+
+  CHECK(vm_mem_write32(vm, 0x10000000u, 0) == -13);
+  CHECK(v4_mem_write8_core(vm, 0x10000000u, 0) == -13);
+  CHECK(kRomTable[0] == 0x01);
+
+  // Read-write bank writes through to the host buffer
+  CHECK(vm_mem_write32(vm, 0x20000008u, 0x11223344u) == 0);
+  CHECK(bank[8] == 0x44);
+  CHECK(v4_mem_write16_core(vm, 0x2000000Eu, 0xBEEF) == 0);
+  CHECK(bank[15] == 0xBE);
+
+  // Between regions and above RAM there is nothing
+  CHECK(vm_mem_read32(vm, 0x18000000u, &out) == -13);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("vm_register_word_at executes bytecode in place")
+{
+  // LIT 7; LIT 6; MUL; RET
+  static const uint8_t kRomCode[] = {(v4_u8)v4::Op::LIT, 7, 0, 0, 0, (v4_u8)v4::Op::LIT,
+                                     6, 0, 0, 0, (v4_u8)v4::Op::MUL, (v4_u8)v4::Op::RET};
+  uint8_t ram[32] = {};
+  const V4_Region regions[] = {
+      {0x08000000u, sizeof(kRomCode), kRomCode, V4_REGION_READ | V4_REGION_EXEC},
+      {0x10000000u, sizeof(kRomTable), kRomTable, V4_REGION_READ},
+  };
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), nullptr, 0, nullptr, V4_MEM_CHECKED, regions, 2};
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  const int idx = vm_register_word_at(vm, "answer", 0x08000000u, (int)sizeof(kRomCode));
+  REQUIRE(idx == 0);
+  CHECK(vm_get_word(vm, idx)->code == kRomCode);
+  CHECK(vm_exec(vm, vm_get_word(vm, idx)) == 0);
+  CHECK(vm_ds_peek_public(vm, 0) == 42);
+
+  // Not executable, past the end, or unmapped
+  CHECK(vm_register_word_at(vm, nullptr, 0x10000000u, 4) == -13);
+  CHECK(vm_register_word_at(vm, nullptr, 0x08000004u, (int)sizeof(kRomCode)) == -13);
+  CHECK(vm_register_word_at(vm, nullptr, 0x30000000u, 4) == -13);
+
+  // Primary RAM is always executable
+  ram[0] = (v4_u8)v4::Op::RET;
+  CHECK(vm_register_word_at(vm, nullptr, 0u, 1) == 1);
+
+  vm_destroy(vm);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Guard-page backed RAM (V4_MEM_GUARDED)                                    */
+/* ------------------------------------------------------------------------- */
+#ifdef V4_HAVE_GUARDED_MEM
+
+/* LIT addr; <op>; RET */
+static v4_err run_mem_op(Vm *vm, v4_u32 addr, v4::Op op)
+{
+  v4_u8 code[] = {(v4_u8)v4::Op::LIT,
+                  (v4_u8)addr,
+                  (v4_u8)(addr >> 8),
+                  (v4_u8)(addr >> 16),
+                  (v4_u8)(addr >> 24),
+                  (v4_u8)op,
+                  (v4_u8)v4::Op::RET};
+  return vm_exec_raw(vm, code, (int)sizeof(code));
+}
+
+TEST_CASE("V4_MEM_GUARDED traps out-of-range access as OobMemory")
+{
+  // 100 bytes: not a page multiple, so the page tail must still fault
+  VmConfig cfg{nullptr, 100u, nullptr, 0, nullptr, V4_MEM_GUARDED};
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+  REQUIRE(vm->mem);
+
+  vm->mem[96] = 0x2A;
+  CHECK(run_mem_op(vm, 96u, v4::Op::LOAD) == 0);
+  CHECK(vm_ds_peek_public(vm, 0) == 0x2A);
+  vm_ds_clear(vm);
+
+  CHECK(run_mem_op(vm, 100u, v4::Op::LOAD) == -13);
+  CHECK(run_mem_op(vm, 99u, v4::Op::LOAD16U) == -13);
+  CHECK(run_mem_op(vm, 0xFFFFFFFCu, v4::Op::LOAD) == -13);
+  CHECK(run_mem_op(vm, 99u, v4::Op::LOAD8U) == 0);
+  vm_ds_clear(vm);
+
+  // Same precedence as checked mode: OOB before Unaligned
+  CHECK(run_mem_op(vm, 101u, v4::Op::LOAD) == -13);
+  CHECK(run_mem_op(vm, 2u, v4::Op::LOAD) == -12);
+
+  // Outside bytecode execution the public API falls back to range checks
+  v4_u32 out = 0;
+  CHECK(vm_mem_read32(vm, 100u, &out) == -13);
+  CHECK(vm_mem_write32(vm, 4u, 0xCAFEF00Du) == 0);
+  CHECK(vm_mem_read32(vm, 4u, &out) == 0);
+  CHECK(out == 0xCAFEF00Du);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("V4_MEM_GUARDED fault unwinds nested calls")
+{
+  VmConfig cfg{nullptr, 64u, nullptr, 0, nullptr, V4_MEM_GUARDED};
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  // Word 0: LIT 0x1000; STORE8; RET (value comes from the caller)
+  v4_u8 bad[] = {(v4_u8)v4::Op::LIT, 0x00, 0x10, 0x00, 0x00, (v4_u8)v4::Op::STORE8,
+                 (v4_u8)v4::Op::RET};
+  REQUIRE(vm_register_word(vm, "bad", bad, (int)sizeof(bad)) == 0);
+
+  v4_u8 main_code[] = {(v4_u8)v4::Op::LIT1, (v4_u8)v4::Op::CALL, 0, 0,
+                       (v4_u8)v4::Op::RET};
+  CHECK(vm_exec_raw(vm, main_code, (int)sizeof(main_code)) == -13);
+  CHECK(vm->guard_frame == nullptr);
+  CHECK(vm->fp == nullptr);
+
+  // The handler runs with SA_NODEFER, so the jump out leaves SIGSEGV unblocked
+  sigset_t mask;
+  REQUIRE(sigprocmask(SIG_BLOCK, nullptr, &mask) == 0);
+  CHECK(!sigismember(&mask, SIGSEGV));
+
+  // The VM stays usable after a trapped fault
+  CHECK(run_mem_op(vm, 60u, v4::Op::LOAD) == 0);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("V4_MEM_GUARDED rejects caller-provided RAM")
+{
+  uint8_t ram[64] = {};
+  VmConfig cfg{ram, 64u, nullptr, 0, nullptr, V4_MEM_GUARDED};
+  CHECK(vm_create(&cfg) == nullptr);
+}
+
+#endif  // V4_HAVE_GUARDED_MEM
+
+/* ------------------------------------------------------------------------- */
+/* File-backed RAM (VmConfig::mem_file)                                      */
+/* ------------------------------------------------------------------------- */
+#ifdef V4_HAVE_MEM_FILE
+
+TEST_CASE("File-backed RAM persists across VM restarts")
+{
+  char path[] = "/tmp/v4_mem_file_XXXXXX";
+  const int fd = mkstemp(path);
+  REQUIRE(fd >= 0);
+  close(fd);
+
+  VmConfig cfg{};
+  cfg.mem_size = 4096;
+  cfg.mem_file = path;
+  cfg.mem_sync = V4_SYNC_AFTER_EXEC;
+
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+  REQUIRE(vm->mem);
+
+  // LIT 0x5EED; LIT 128; STORE; RET
+  v4_u8 code[] = {(v4_u8)v4::Op::LIT, 0xED, 0x5E, 0x00, 0x00,
+                  (v4_u8)v4::Op::LIT, 0x80, 0x00, 0x00, 0x00,
+                  (v4_u8)v4::Op::STORE, (v4_u8)v4::Op::RET};
+  REQUIRE(vm_register_word(vm, "init", code, (int)sizeof(code)) == 0);
+  CHECK(vm_exec(vm, vm_get_word(vm, 0)) == 0);
+  CHECK(vm_mem_write32(vm, 4092u, 0xA5A55A5Au) == 0);
+  CHECK(vm_mem_sync(vm, 1) == 0);
+  vm_destroy(vm);
+
+  vm = vm_create(&cfg);
+  REQUIRE(vm);
+  v4_u32 out = 0;
+  CHECK(vm_mem_read32(vm, 128u, &out) == 0);
+  CHECK(out == 0x5EEDu);
+  CHECK(vm_mem_read32(vm, 4092u, &out) == 0);
+  CHECK(out == 0xA5A55A5Au);
+  vm_destroy(vm);
+
+  unlink(path);
+}
+
+TEST_CASE("File-backed RAM honours masked mode and rejects bad configs")
+{
+  char path[] = "/tmp/v4_mem_file_XXXXXX";
+  const int fd = mkstemp(path);
+  REQUIRE(fd >= 0);
+  close(fd);
+
+  VmConfig cfg{};
+  cfg.mem_size = 1024;
+  cfg.mem_file = path;
+  cfg.mem_mode = V4_MEM_MASKED;
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+  CHECK(vm->mem_mask == 1023u);
+  CHECK(vm->mem_map_len == 1024u + V4_MEM_GUARD_BYTES);
+  vm_destroy(vm);
+
+  // Caller RAM and a file are mutually exclusive
+  uint8_t ram[64] = {};
+  cfg.mem = ram;
+  cfg.mem_mode = V4_MEM_CHECKED;
+  CHECK(vm_create(&cfg) == nullptr);
+
+  // Unopenable path
+  cfg.mem = nullptr;
+  cfg.mem_file = "/nonexistent-dir/v4.ram";
+  CHECK(vm_create(&cfg) == nullptr);
+
+  // Non-file-backed RAM: sync is a no-op
+  VmConfig plain{};
+  plain.mem = ram;
+  plain.mem_size = sizeof(ram);
+  vm = vm_create(&plain);
+  REQUIRE(vm);
+  CHECK(vm_mem_sync(vm, 1) == 0);
+  vm_destroy(vm);
+
+  unlink(path);
+}
+
+#endif  // V4_HAVE_MEM_FILE
+
+/* ------------------------------------------------------------------------- */
+/* Sparse RAM (V4_MEM_PAGED)                                                 */
+/* ------------------------------------------------------------------------- */
+#ifdef V4_HAVE_PAGED_MEM
+
+TEST_CASE("V4_MEM_PAGED commits pages on first write only")
+{
+  const long page = sysconf(_SC_PAGESIZE);
+  VmConfig cfg{};
+  cfg.mem_size = 0x40000000u;  // 1 GiB address space
+  cfg.mem_mode = V4_MEM_PAGED;
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+  CHECK(vm_mem_resident(vm) == 0);
+
+  // Heap low, stack high, mailbox in between
+  CHECK(vm_mem_write32(vm, 0x100u, 0x11111111u) == 0);
+  CHECK(vm_mem_write32(vm, 0x3FFFFFFCu, 0x22222222u) == 0);
+  CHECK(vm_mem_write32(vm, 0x20000000u, 0x33333333u) == 0);
+  CHECK(vm_mem_resident(vm) == (size_t)(3 * page));
+
+  v4_u32 out = 1;
+  CHECK(vm_mem_read32(vm, 0x3FFFFFFCu, &out) == 0);
+  CHECK(out == 0x22222222u);
+  CHECK(vm_mem_read32(vm, 0x10000000u, &out) == 0);
+  CHECK(out == 0u);  // never written
+  CHECK(vm_mem_read32(vm, 0x40000000u, &out) == -13);  // OobMemory
+
+  // Reads of untouched pages may map the shared zero page; measure from here
+  const size_t base = vm_mem_resident(vm);
+
+  // Bytecode runs against it like any RAM: LIT 7; LIT 0x30000000; STORE; RET
+  v4_u8 code[] = {(v4_u8)v4::Op::LIT, 0x07, 0x00, 0x00, 0x00,
+                  (v4_u8)v4::Op::LIT, 0x00, 0x00, 0x00, 0x30,
+                  (v4_u8)v4::Op::STORE, (v4_u8)v4::Op::RET};
+  CHECK(vm_exec_raw(vm, code, (int)sizeof(code)) == 0);
+  CHECK(vm_mem_read32(vm, 0x30000000u, &out) == 0);
+  CHECK(out == 7u);
+  CHECK(vm_mem_resident(vm) == base + (size_t)page);
+
+  // Discard hands whole pages back and leaves the range zeroed
+  CHECK(vm_mem_discard(vm, 0x20000000u, (v4_u32)page) == 0);
+  CHECK(vm_mem_resident(vm) == base);
+  CHECK(vm_mem_read32(vm, 0x20000000u, &out) == 0);
+  CHECK(out == 0u);
+  CHECK(vm_mem_discard(vm, 0x3FFFFFF0u, 0x20u) == -13);  // OobMemory
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("V4_MEM_PAGED rejects caller RAM and forks sparsely")
+{
+  uint8_t ram[64] = {};
+  VmConfig cfg{};
+  cfg.mem = ram;
+  cfg.mem_size = sizeof(ram);
+  cfg.mem_mode = V4_MEM_PAGED;
+  CHECK(vm_create(&cfg) == nullptr);
+
+  cfg.mem = nullptr;
+  cfg.mem_size = 0x10000000u;
+  Vm *tmpl = vm_create(&cfg);
+  REQUIRE(tmpl);
+  CHECK(vm_mem_write32(tmpl, 0x0FFFFF00u, 0xCAFEF00Du) == 0);
+
+  Vm *child = vm_fork(tmpl);
+  REQUIRE(child);
+  v4_u32 out = 0;
+  CHECK(vm_mem_read32(child, 0x0FFFFF00u, &out) == 0);
+  CHECK(out == 0xCAFEF00Du);
+  CHECK(vm_mem_read32(child, 0x08000000u, &out) == 0);
+  CHECK(out == 0u);
+
+  // Discarding fork RAM clears in place instead of re-reading the image
+  CHECK(vm_mem_discard(child, 0x0FFFFF00u, 4u) == 0);
+  CHECK(vm_mem_read32(child, 0x0FFFFF00u, &out) == 0);
+  CHECK(out == 0u);
+  CHECK(vm_mem_read32(tmpl, 0x0FFFFF00u, &out) == 0);
+  CHECK(out == 0xCAFEF00Du);
+
+  vm_destroy(child);
+  vm_destroy(tmpl);
+}
+
+TEST_CASE("V4_MEM_PAGED checkpoint saves only the pages written")
+{
+  VmConfig cfg{};
+  cfg.mem_size = 0x40000000u;  // 1 GiB; a full shadow copy would not do
+  cfg.mem_mode = V4_MEM_PAGED;
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+  REQUIRE(vm_mem_write32(vm, 0x100u, 0x11111111u) == 0);
+
+  REQUIRE(vm_checkpoint(vm) == 0);
+  CHECK(vm->ckpt_cap <= 16u);
+
+  // 40 pages spread over the range: the pool grows past its first slots
+  for (v4_u32 i = 0; i < 40; i++)
+    CHECK(vm_mem_write32(vm, i * 0x01000000u + 0x100u, 0xA0000000u + i) == 0);
+  CHECK(vm->ckpt_count == 40u);
+  CHECK(vm->ckpt_cap >= 40u);
+  CHECK(vm->ckpt_cap <= 64u);
+
+  REQUIRE(vm_rollback(vm) == 0);
+  v4_u32 out = 0;
+  CHECK(vm_mem_read32(vm, 0x100u, &out) == 0);
+  CHECK(out == 0x11111111u);
+  CHECK(vm_mem_read32(vm, 0x27000100u, &out) == 0);
+  CHECK(out == 0u);
+
+  vm_checkpoint_end(vm);
+  CHECK(vm->ckpt_shadow == nullptr);
+  vm_destroy(vm);
+}
+
+#endif  // V4_HAVE_PAGED_MEM
+
+/* ------------------------------------------------------------------------- */
+/* Copy-on-write fork (vm_fork)                                              */
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("vm_fork shares the template image copy-on-write")
+{
+  static uint8_t ram[8192];
+  memset(ram, 0, sizeof(ram));
+  VmConfig cfg{};
+  cfg.mem = ram;
+  cfg.mem_size = sizeof(ram);
+  Vm *tmpl = vm_create(&cfg);
+  REQUIRE(tmpl);
+
+  // Warm up: RAM contents, a named word and a value on the data stack
+  CHECK(vm_mem_write32(tmpl, 16u, 0x11223344u) == 0);
+  v4_u8 inc[] = {(v4_u8)v4::Op::LIT1, (v4_u8)v4::Op::ADD, (v4_u8)v4::Op::RET};
+  REQUIRE(vm_register_word(tmpl, "inc", inc, (int)sizeof(inc)) == 0);
+  vm_ds_push(tmpl, 41);
+
+  Vm *a = vm_fork(tmpl);
+  Vm *b = vm_fork(tmpl);
+  REQUIRE(a);
+  REQUIRE(b);
+  CHECK(a->mem != tmpl->mem);
+
+  v4_u32 out = 0;
+  CHECK(vm_mem_read32(a, 16u, &out) == 0);
+  CHECK(out == 0x11223344u);
+
+  // Writes stay private to each VM
+  CHECK(vm_mem_write32(a, 16u, 0xAAAAAAAAu) == 0);
+  CHECK(vm_mem_read32(b, 16u, &out) == 0);
+  CHECK(out == 0x11223344u);
+  CHECK(vm_mem_read32(tmpl, 16u, &out) == 0);
+  CHECK(out == 0x11223344u);
+
+  // Inherited stack and dictionary
+  CHECK(vm_ds_depth_public(a) == 1);
+  CHECK(vm_find_word(a, "inc") == 0);
+  CHECK(vm_exec(a, vm_get_word(a, 0)) == 0);
+  CHECK(vm_ds_peek_public(a, 0) == 42);
+  CHECK(vm_ds_peek_public(tmpl, 0) == 41);
+
+  // Fork-local words do not leak into the template
+  CHECK(vm_register_word(b, "local", inc, (int)sizeof(inc)) == 1);
+  CHECK(vm_find_word(tmpl, "local") < 0);
+
+  vm_destroy(a);
+  vm_destroy(b);
+  CHECK(vm_word_get_name(vm_get_word(tmpl, 0)) != nullptr);
+  vm_destroy(tmpl);
+}
+
+TEST_CASE("vm_fork after a template write sees the new RAM")
+{
+  static uint8_t ram[8192];
+  memset(ram, 0, sizeof(ram));
+  VmConfig cfg{};
+  cfg.mem = ram;
+  cfg.mem_size = sizeof(ram);
+  Vm *tmpl = vm_create(&cfg);
+  REQUIRE(tmpl);
+  CHECK(vm_mem_write32(tmpl, 64u, 1) == 0);
+
+  Vm *a = vm_fork(tmpl);
+  REQUIRE(a);
+  CHECK(vm_mem_write32(tmpl, 64u, 2) == 0);
+  CHECK(vm_mem_write32(tmpl, 4096u, 3) == 0);
+  Vm *b = vm_fork(tmpl);
+  REQUIRE(b);
+
+  v4_u32 out = 0;
+  CHECK(vm_mem_read32(b, 64u, &out) == 0);
+  CHECK(out == 2);
+  CHECK(vm_mem_read32(b, 4096u, &out) == 0);
+  CHECK(out == 3);
+  CHECK(vm_mem_read32(a, 64u, &out) == 0);  // earlier fork keeps its image
+  CHECK(out == 1);
+  CHECK(vm_mem_read32(a, 4096u, &out) == 0);
+  CHECK(out == 0);
+
+  // Rolling the template back also counts as a write
+  REQUIRE(vm_checkpoint(tmpl) == 0);
+  CHECK(vm_mem_write32(tmpl, 64u, 4) == 0);
+  Vm *c = vm_fork(tmpl);
+  REQUIRE(c);
+  REQUIRE(vm_rollback(tmpl) == 0);
+  Vm *d = vm_fork(tmpl);
+  REQUIRE(d);
+  CHECK(vm_mem_read32(c, 64u, &out) == 0);
+  CHECK(out == 4);
+  CHECK(vm_mem_read32(d, 64u, &out) == 0);
+  CHECK(out == 2);
+  vm_checkpoint_end(tmpl);
+
+  vm_destroy(a);
+  vm_destroy(b);
+  vm_destroy(c);
+  vm_destroy(d);
+  vm_destroy(tmpl);
+}
+
+TEST_CASE("vm_fork keeps masked mode and rebases in-place words")
+{
+  static uint8_t ram[1024 + V4_MEM_GUARD_BYTES];
+  VmConfig cfg{};
+  cfg.mem = ram;
+  cfg.mem_size = 1024;
+  cfg.mem_mode = V4_MEM_MASKED;
+  Vm *tmpl = vm_create(&cfg);
+  REQUIRE(tmpl);
+
+  // LIT0; RET stored in RAM and executed in place
+  ram[64] = (v4_u8)v4::Op::LIT0;
+  ram[65] = (v4_u8)v4::Op::RET;
+  REQUIRE(vm_register_word_at(tmpl, "zero", 64u, 2) == 0);
+
+  Vm *f = vm_fork(tmpl);
+  REQUIRE(f);
+  CHECK(f->mem_mask == 1023u);
+  CHECK(vm_get_word(f, 0)->code == f->mem + 64);
+  CHECK(vm_exec(f, vm_get_word(f, 0)) == 0);
+  CHECK(vm_ds_peek_public(f, 0) == 0);
+
+  vm_destroy(f);
+  vm_destroy(tmpl);
+}
+
+#ifdef V4_HAVE_GUARDED_MEM
+TEST_CASE("vm_fork of a guarded template keeps fault-driven OOB")
+{
+  VmConfig cfg{nullptr, 100u, nullptr, 0, nullptr, V4_MEM_GUARDED};
+  Vm *tmpl = vm_create(&cfg);
+  REQUIRE(tmpl);
+  tmpl->mem[96] = 0x5A;
+
+  Vm *f = vm_fork(tmpl);
+  REQUIRE(f);
+  CHECK(run_mem_op(f, 96u, v4::Op::LOAD) == 0);
+  CHECK(vm_ds_peek_public(f, 0) == 0x5A);
+  CHECK(run_mem_op(f, 100u, v4::Op::LOAD) == -13);
+
+  vm_destroy(f);
+  vm_destroy(tmpl);
+}
+#endif  // V4_HAVE_GUARDED_MEM
+
+/* ------------------------------------------------------------------------- */
+/* Checkpoint / rollback                                                     */
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("vm_rollback restores only pages written since vm_checkpoint")
+{
+  // Odd size: the last page is partial
+  static uint8_t ram[4000];
+  for (size_t i = 0; i < sizeof(ram); i++)
+    ram[i] = (uint8_t)i;
+  VmConfig cfg{};
+  cfg.mem = ram;
+  cfg.mem_size = sizeof(ram);
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  CHECK(vm_rollback(vm) == -16);  // nothing to roll back to
+  REQUIRE(vm_checkpoint(vm) == 0);
+
+  // STORE, STORE8 across a page boundary via STORE16, and the last byte
+  CHECK(vm_mem_write32(vm, 8u, 0xDEADBEEFu) == 0);
+  v4_u8 code[] = {(v4_u8)v4::Op::LIT, 0x34, 0x12, 0x00, 0x00,
+                  (v4_u8)v4::Op::LIT, 0xFF, 0x00, 0x00, 0x00,
+                  (v4_u8)v4::Op::STORE16,
+                  (v4_u8)v4::Op::LIT, 0x77, 0x00, 0x00, 0x00,
+                  (v4_u8)v4::Op::LIT, 0x9F, 0x0F, 0x00, 0x00,
+                  (v4_u8)v4::Op::STORE8,
+                  (v4_u8)v4::Op::RET};
+  REQUIRE(vm_exec_raw(vm, code, (int)sizeof(code)) == 0);
+  CHECK(ram[255] == 0x34);
+  CHECK(ram[256] == 0x12);
+  CHECK(ram[3999] == 0x77);
+  CHECK(vm->ckpt_count == 3);  // pages 0, 1 and 15
+
+  REQUIRE(vm_rollback(vm) == 0);
+  CHECK(vm->ckpt_count == 0);
+  for (size_t i = 0; i < sizeof(ram); i++)
+    REQUIRE(ram[i] == (uint8_t)i);
+
+  // A new checkpoint commits the current contents
+  CHECK(vm_mem_write32(vm, 512u, 0x01020304u) == 0);
+  REQUIRE(vm_checkpoint(vm) == 0);
+  CHECK(vm_mem_write32(vm, 512u, 0u) == 0);
+  REQUIRE(vm_rollback(vm) == 0);
+  v4_u32 out = 0;
+  CHECK(vm_mem_read32(vm, 512u, &out) == 0);
+  CHECK(out == 0x01020304u);
+
+  vm_checkpoint_end(vm);
+  CHECK(vm_rollback(vm) == -16);
+  vm_destroy(vm);
+}
+
+TEST_CASE("Checkpoint tracks masked-mode and kernel writes")
+{
+  static uint8_t ram[1024 + V4_MEM_GUARD_BYTES];
+  memset(ram, 0, sizeof(ram));
+  VmConfig cfg{};
+  cfg.mem = ram;
+  cfg.mem_size = 1024;
+  cfg.mem_mode = V4_MEM_MASKED;
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+  REQUIRE(vm_checkpoint(vm) == 0);
+
+  // Wrapped address 1024 + 16 lands on RAM offset 16
+  CHECK(vm_mem_write32(vm, 1040u, 0xCAFEBABEu) == 0);
+  CHECK(ram[16] == 0xBE);
+
+  // FMT_DEC ( n addr cap -- len ) writes through the kernel path
+  vm_ds_push(vm, 12345);
+  vm_ds_push(vm, 768);
+  vm_ds_push(vm, 16);
+  v4_u8 code[] = {(v4_u8)v4::Op::LIT, 0x20, 0x01, 0x00, 0x00,
+                  (v4_u8)v4::Op::SYS, (v4_u8)v4::Op::RET};
+  REQUIRE(vm_exec_raw(vm, code, (int)sizeof(code)) == 0);
+  CHECK(memcmp(ram + 768, "12345", 5) == 0);
+
+  REQUIRE(vm_rollback(vm) == 0);
+  for (size_t i = 0; i < 1024; i++)
+    REQUIRE(ram[i] == 0);
+  vm_destroy(vm);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Bulk transfer and views                                                   */
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("vm_mem_read_block/vm_mem_write_block copy whole ranges")
+{
+  static uint8_t ram[4096];
+  static const uint8_t rom[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+  memset(ram, 0, sizeof(ram));
+  Dummy dev;
+  V4_Mmio mmio = {0x20000000u, 0x100u, d_read32, d_write32, &dev};
+  V4_Region region = {0x10000000u, sizeof(rom), rom, V4_REGION_READ};
+  VmConfig cfg{ram, sizeof(ram), &mmio, 1, nullptr, V4_MEM_CHECKED, &region, 1};
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  uint8_t frame[1000];
+  for (size_t i = 0; i < sizeof(frame); i++)
+    frame[i] = (uint8_t)(i * 7);
+
+  // Unaligned start is fine
+  CHECK(vm_mem_write_block(vm, 3u, frame, sizeof(frame)) == 0);
+  CHECK(memcmp(ram + 3, frame, sizeof(frame)) == 0);
+  uint8_t back[1000] = {};
+  CHECK(vm_mem_read_block(vm, 3u, back, sizeof(back)) == 0);
+  CHECK(memcmp(back, frame, sizeof(frame)) == 0);
+
+  // Regions: readable, but not writable without V4_REGION_WRITE
+  uint8_t r[4] = {};
+  CHECK(vm_mem_read_block(vm, 0x10000004u, r, 4) == 0);
+  CHECK(r[0] == 5);
+  CHECK(vm_mem_write_block(vm, 0x10000004u, r, 4) == -13);
+
+  // Partially out of range, across the MMIO window end, and empty transfers
+  CHECK(vm_mem_write_block(vm, 4000u, frame, 200) == -13);
+  CHECK(vm_mem_read_block(vm, 0x200000FCu, r, 8) == -13);
+  CHECK(vm_mem_read_block(vm, 0u, nullptr, 0) == 0);
+  CHECK(vm_mem_read_block(vm, 0u, nullptr, 4) == -16);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("vm_mem_view returns host spans for plain memory only")
+{
+  static uint8_t ram[1024];
+  static const uint8_t rom[8] = {0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7};
+  memset(ram, 0, sizeof(ram));
+  V4_Region region = {0x10000000u, sizeof(rom), rom, V4_REGION_READ};
+  VmConfig cfg{ram, sizeof(ram), nullptr, 0, nullptr, V4_MEM_CHECKED, &region, 1};
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  uint8_t *v = vm_mem_view(vm, 100u, 24u, 1);
+  REQUIRE(v == ram + 100);
+  CHECK(vm_mem_view(vm, 1000u, 25u, 0) == nullptr);
+  CHECK(vm_mem_view(vm, 0u, 0u, 0) == nullptr);
+
+  CHECK(vm_mem_view(vm, 0x10000002u, 4u, 0) == rom + 2);
+  CHECK(vm_mem_view(vm, 0x10000002u, 4u, 1) == nullptr);
+
+  // Writable views are recorded for rollback when they are created
+  REQUIRE(vm_checkpoint(vm) == 0);
+  v = vm_mem_view(vm, 300u, 4u, 1);
+  REQUIRE(v);
+  memcpy(v, "\x01\x02\x03\x04", 4);
+  REQUIRE(vm_rollback(vm) == 0);
+  CHECK(ram[300] == 0);
+
+  vm_destroy(vm);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Shared regions and atomic cells                                           */
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("Shared region exchanges data between VMs with atomics")
+{
+  alignas(4) static uint8_t shared[64];
+  memset(shared, 0, sizeof(shared));
+  uint8_t ram_a[64] = {}, ram_b[64] = {};
+  V4_Region at_a = {0x1000u, sizeof(shared), shared,
+                    V4_REGION_READ | V4_REGION_WRITE | V4_REGION_SHARED};
+  V4_Region at_b = at_a;
+  at_b.base = 0x8000u;  // same buffer, different address in the consumer
+  VmConfig ca{ram_a, sizeof(ram_a), nullptr, 0, nullptr, V4_MEM_CHECKED, &at_a, 1};
+  VmConfig cb{ram_b, sizeof(ram_b), nullptr, 0, nullptr, V4_MEM_CHECKED, &at_b, 1};
+  Vm *a = vm_create(&ca);
+  Vm *b = vm_create(&cb);
+  REQUIRE(a);
+  REQUIRE(b);
+
+  // Producer: payload with plain STORE, then publish the flag with ASTORE
+  v4_u8 produce[] = {(v4_u8)v4::Op::LIT, 0x78, 0x56, 0x34, 0x12,
+                     (v4_u8)v4::Op::LIT, 0x10, 0x10, 0x00, 0x00,
+                     (v4_u8)v4::Op::STORE,
+                     (v4_u8)v4::Op::LIT1,
+                     (v4_u8)v4::Op::LIT, 0x00, 0x10, 0x00, 0x00,
+                     (v4_u8)v4::Op::ASTORE,
+                     (v4_u8)v4::Op::RET};
+  REQUIRE(vm_exec_raw(a, produce, (int)sizeof(produce)) == 0);
+
+  // Consumer: ALOAD the flag, then read the payload through its own base
+  v4_u8 consume[] = {(v4_u8)v4::Op::LIT, 0x00, 0x80, 0x00, 0x00,
+                     (v4_u8)v4::Op::ALOAD,
+                     (v4_u8)v4::Op::LIT, 0x10, 0x80, 0x00, 0x00,
+                     (v4_u8)v4::Op::LOAD,
+                     (v4_u8)v4::Op::FENCE,
+                     (v4_u8)v4::Op::RET};
+  REQUIRE(vm_exec_raw(b, consume, (int)sizeof(consume)) == 0);
+  CHECK(vm_ds_peek_public(b, 0) == 0x12345678);
+  CHECK(vm_ds_peek_public(b, 1) == 1);
+  vm_ds_clear(b);
+
+  // AADD / CAS return the previous value
+  v4_u8 rmw[] = {(v4_u8)v4::Op::LIT_U8, 5,
+                 (v4_u8)v4::Op::LIT, 0x04, 0x80, 0x00, 0x00,
+                 (v4_u8)v4::Op::AADD,
+                 (v4_u8)v4::Op::LIT_U8, 5, (v4_u8)v4::Op::LIT_U8, 9,
+                 (v4_u8)v4::Op::LIT, 0x04, 0x80, 0x00, 0x00,
+                 (v4_u8)v4::Op::CAS,
+                 (v4_u8)v4::Op::LIT_U8, 5, (v4_u8)v4::Op::LIT_U8, 7,
+                 (v4_u8)v4::Op::LIT, 0x04, 0x80, 0x00, 0x00,
+                 (v4_u8)v4::Op::CAS,
+                 (v4_u8)v4::Op::RET};
+  REQUIRE(vm_exec_raw(b, rmw, (int)sizeof(rmw)) == 0);
+  CHECK(vm_ds_peek_public(b, 2) == 0);  // AADD saw 0
+  CHECK(vm_ds_peek_public(b, 1) == 5);  // CAS 5 -> 9 succeeded
+  CHECK(vm_ds_peek_public(b, 0) == 9);  // CAS 5 -> 7 failed
+  v4_u32 out = 0;
+  CHECK(vm_mem_read32(a, 0x1004u, &out) == 0);
+  CHECK(out == 9u);
+  CHECK(shared[4] == 9);  // little-endian in the buffer
+
+  vm_destroy(a);
+  vm_destroy(b);
+}
+
+TEST_CASE("Atomic cells: RAM, errors and shared-region alignment")
+{
+  alignas(4) static uint8_t ram[64];
+  memset(ram, 0, sizeof(ram));
+  Dummy dev;
+  V4_Mmio m = {0x2000u, 0x10u, d_read32, d_write32, &dev};
+  VmConfig cfg{ram, sizeof(ram), &m, 1};
+  Vm *vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  v4_u32 old = 0;
+  CHECK(v4_mem_aadd32(vm, 8u, 3u, &old) == 0);
+  CHECK(v4_mem_aadd32(vm, 8u, 0xFFFFFFFFu, &old) == 0);
+  CHECK(old == 3u);
+  CHECK(ram[8] == 2);
+  CHECK(v4_mem_astore32(vm, 12u, 0x01020304u) == 0);
+  CHECK(ram[12] == 0x04);
+  CHECK(v4_mem_aload32(vm, 12u, &old) == 0);
+  CHECK(old == 0x01020304u);
+
+  CHECK(v4_mem_aload32(vm, 64u, &old) == -13);
+  CHECK(v4_mem_aload32(vm, 6u, &old) == -12);
+  CHECK(v4_mem_astore32(vm, 0x2000u, 1u) == -13);  // callback MMIO
+  vm_destroy(vm);
+
+  // Shared regions must be cell-aligned on both sides
+  alignas(4) static uint8_t buf[16];
+  V4_Region r = {0x1002u, 8u, buf, V4_REGION_READ | V4_REGION_SHARED};
+  VmConfig bad{ram, sizeof(ram), nullptr, 0, nullptr, V4_MEM_CHECKED, &r, 1};
+  CHECK(vm_create(&bad) == nullptr);
+  r.base = 0x1000u;
+  r.data = buf + 1;
+  CHECK(vm_create(&bad) == nullptr);
+}
@@ -0,0 +1,131 @@
+// tests/test_no_malloc.c — V4_NO_MALLOC build: every VM allocation from one arena
+//
+// Linked with --wrap for the C/C++ heap entry points (see CMakeLists.txt)
+// and no __wrap_* definitions: if anything in the engine still references
+// malloc/free, this program fails to link.
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "v4/arena.h"
+#include "v4/task.h"
+#include "v4/vm_api.h"
+
+static uint8_t g_store[64 * 1024] __attribute__((aligned(16)));
+
+#define FAIL(code, msg)                              \
+  do                                                 \
+  {                                                  \
+    fprintf(stderr, "test_no_malloc: %s\n", (msg));  \
+    return (code);                                   \
+  } while (0)
+
+int main(void)
+{
+  uint8_t ram[1024] = {0};
+  V4Arena arena;
+  v4_arena_init(&arena, g_store, sizeof(g_store));
+
+  VmConfig cfg = {0};
+  cfg.mem = ram;
+  cfg.mem_size = (v4_u32)sizeof(ram);
+
+  // No arena: nothing to allocate the VM from
+  if (vm_create(&cfg))
+    FAIL(1, "vm_create without an arena must fail");
+
+  cfg.arena = &arena;
+  cfg.heap_base = 512;
+  cfg.heap_size = 512;
+  struct Vm *vm = vm_create(&cfg);
+  if (!vm)
+    FAIL(2, "vm_create failed");
+  const size_t boot = v4_arena_used(&arena);
+  if (boot == 0)
+    FAIL(3, "VM was not placed in the arena");
+
+  // Word names
+  const uint8_t code[] = {0x00, 2, 0, 0, 0, 0x00, 3, 0, 0, 0, 0x10, 0x51};
+  const int idx = vm_register_word(vm, "five", code, (int)sizeof(code));
+  if (idx < 0)
+    FAIL(4, "vm_register_word failed");
+  if (vm_exec(vm, vm_get_word(vm, idx)) != 0 || vm_ds_peek_public(vm, 0) != 5)
+    FAIL(5, "vm_exec failed");
+
+  // Snapshots
+  struct VmStackSnapshot *snap = vm_ds_snapshot(vm);
+  if (!snap || snap->depth != 1)
+    FAIL(6, "vm_ds_snapshot failed");
+  vm_ds_clear(vm);
+  if (vm_ds_restore(vm, snap) != 0 || vm_ds_peek_public(vm, 0) != 5)
+    FAIL(7, "vm_ds_restore failed");
+  const size_t with_snap = v4_arena_used(&arena);
+  vm_ds_snapshot_free(snap);
+  const size_t no_snap = v4_arena_used(&arena);
+  if (no_snap >= with_snap)
+    FAIL(18, "vm_ds_snapshot_free did not give the arena back");
+  for (int i = 0; i < 64; i++)
+    vm_ds_snapshot_free(vm_ds_snapshot(vm));
+  if (v4_arena_used(&arena) != no_snap)
+    FAIL(19, "snapshot/free loop grew the arena");
+
+  // Task stacks; a respawn into the same slot reuses its stacks
+  if (vm_task_init(vm, 10) != 0)
+    FAIL(8, "vm_task_init failed");
+  if (vm_task_spawn(vm, (uint16_t)idx, 1, 32, 16) < 0)
+    FAIL(9, "vm_task_spawn failed");
+  vm_task_cleanup(vm);
+
+  // Checkpoint buffers are given back when tracking ends
+  const size_t before_ckpt = v4_arena_used(&arena);
+  if (vm_checkpoint(vm) != 0)
+    FAIL(10, "vm_checkpoint failed");
+  vm_checkpoint_end(vm);
+  if (v4_arena_used(&arena) != before_ckpt)
+    FAIL(11, "checkpoint buffers were not released");
+
+  // Growth needs the heap and is refused
+  V4Arena grow;
+  v4_arena_init_chained(&grow, NULL, 0, 256);
+  if (v4_arena_alloc(&grow, 16, 8))
+    FAIL(12, "chained arena grew without malloc");
+
+  // A second VM whose dictionary and decode table are replaced as they grow
+  // frees blocks out of order; the space is reused, and all of it comes
+  // back when the VM is destroyed
+  const size_t before_vm = v4_arena_used(&arena);
+  VmConfig cfg2 = cfg;
+  cfg2.heap_size = 0;
+  cfg2.dict_words = 2;
+  cfg2.dict_max_words = 64;
+  cfg2.code_arena_size = 256;
+  struct Vm *vm2 = vm_create(&cfg2);
+  if (!vm2)
+    FAIL(13, "second vm_create failed");
+  V4_Mmio win = {0};
+  win.size = 16;
+  for (int i = 0; i < 20; i++)
+  {
+    win.base = 0x10000u + 0x100u * (v4_u32)i;
+    if (vm_register_word(vm2, NULL, code, (int)sizeof(code)) != i ||
+        vm_register_mmio(vm2, &win, 1) != 0)
+      FAIL(14, "registration failed on the second VM");
+  }
+  const size_t grown = v4_arena_used(&arena) - before_vm;
+  for (int i = 20; i < 40; i++)
+  {
+    win.base = 0x10000u + 0x100u * (v4_u32)i;
+    if (vm_register_mmio(vm2, &win, 1) != 0)
+      FAIL(15, "vm_register_mmio failed");
+  }
+  if (v4_arena_used(&arena) - before_vm > 2 * grown)
+    FAIL(16, "replaced decode tables were not reused");
+  vm_destroy(vm2);
+  if (v4_arena_used(&arena) != before_vm)
+    FAIL(17, "vm_destroy did not give the arena back");
+
+  vm_destroy(vm);
+  v4_arena_reset(&arena);
+  printf("test_no_malloc: OK (%u arena bytes at boot)\n", (unsigned)boot);
+  return 0;
+}
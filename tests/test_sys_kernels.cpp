@@ -0,0 +1,682 @@
+/**
+ * @file test_sys_kernels.cpp
+ * @brief Tests for core SYS kernels operating on VM memory ranges
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <cstring>
+
+#include "doctest.h"
+#include "v4/errors.hpp"
+#include "v4/internal/vm.h"
+#include "v4/opcodes.hpp"
+#include "v4/sys_ids.h"
+#include "v4/vm_api.h"
+
+/* Mock HAL control functions */
+extern "C" void mock_hal_reset(void);
+extern "C" const char* mock_hal_console_get_output(int* out_len);
+
+/* Helper to emit bytecode */
+static void emit8(v4_u8* code, int* k, v4_u8 byte)
+{
+  code[(*k)++] = byte;
+}
+
+static void emit32(v4_u8* code, int* k, v4_u32 val)
+{
+  code[(*k)++] = (val >> 0) & 0xFF;
+  code[(*k)++] = (val >> 8) & 0xFF;
+  code[(*k)++] = (val >> 16) & 0xFF;
+  code[(*k)++] = (val >> 24) & 0xFF;
+}
+
+/* Run `LIT sys_id; SYS; RET` on whatever arguments are already on the stack. */
+static v4_err run_sys(Vm* vm, v4_u16 sys_id)
+{
+  v4_u8 code[16];
+  int k = 0;
+  emit8(code, &k, static_cast<v4_u8>(v4::Op::LIT));
+  emit32(code, &k, sys_id);
+  emit8(code, &k, static_cast<v4_u8>(v4::Op::SYS));
+  emit8(code, &k, static_cast<v4_u8>(v4::Op::RET));
+  return vm_exec_raw(vm, code, k);
+}
+
+/* Run a ( addr len seed -- value ) kernel and return the result. */
+static v4_u32 hash_range(Vm* vm, v4_u16 sys_id, v4_u32 addr, v4_u32 len, v4_u32 seed)
+{
+  vm_ds_push(vm, (v4_i32)addr);
+  vm_ds_push(vm, (v4_i32)len);
+  vm_ds_push(vm, (v4_i32)seed);
+  REQUIRE(run_sys(vm, sys_id) == 0);
+  REQUIRE(vm_ds_depth_public(vm) == 1);
+  v4_i32 out = 0;
+  vm_ds_pop(vm, &out);
+  return (v4_u32)out;
+}
+
+static const char kCheck[] = "123456789";
+
+/* ========================================================================= */
+/* Checksum and hash kernels                                                 */
+/* ========================================================================= */
+
+TEST_CASE("SYS CRC32/CRC32C/CRC16 check values")
+{
+  uint8_t ram[64] = {};
+  memcpy(ram + 8, kCheck, 9);
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), nullptr, 0};
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  CHECK(hash_range(vm, V4_SYS_CRC32, 8, 9, 0) == 0xCBF43926u);
+  CHECK(hash_range(vm, V4_SYS_CRC32C, 8, 9, 0) == 0xE3069283u);
+  CHECK(hash_range(vm, V4_SYS_CRC16_CCITT, 8, 9, 0xFFFF) == 0x29B1u);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("SYS CRC32 chains across calls")
+{
+  uint8_t ram[64] = {};
+  memcpy(ram, kCheck, 9);
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), nullptr, 0};
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  // Feeding the previous CRC back as seed continues the computation
+  const v4_u32 part = hash_range(vm, V4_SYS_CRC32, 0, 4, 0);
+  CHECK(hash_range(vm, V4_SYS_CRC32, 4, 5, part) == 0xCBF43926u);
+
+  const v4_u32 part_c = hash_range(vm, V4_SYS_CRC32C, 0, 3, 0);
+  CHECK(hash_range(vm, V4_SYS_CRC32C, 3, 6, part_c) == 0xE3069283u);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("SYS CRC32 long buffers match byte-wise reference")
+{
+  // Long enough to exercise the sliced / hardware paths and their tails
+  uint8_t ram[1024 + 16];
+  for (size_t i = 0; i < sizeof(ram); i++)
+    ram[i] = (uint8_t)(i * 31 + 7);
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), nullptr, 0};
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  for (v4_u32 off = 0; off < 8; off++)
+  {
+    const v4_u32 len = 1000 + off;
+    v4_u32 crc = 0xFFFFFFFFu;
+    v4_u32 crcc = 0xFFFFFFFFu;
+    for (v4_u32 i = 0; i < len; i++)
+    {
+      crc ^= ram[off + i];
+      crcc ^= ram[off + i];
+      for (int b = 0; b < 8; b++)
+      {
+        crc = (crc & 1u) ? (crc >> 1) ^ 0xEDB88320u : (crc >> 1);
+        crcc = (crcc & 1u) ? (crcc >> 1) ^ 0x82F63B78u : (crcc >> 1);
+      }
+    }
+    CHECK(hash_range(vm, V4_SYS_CRC32, off, len, 0) == ~crc);
+    CHECK(hash_range(vm, V4_SYS_CRC32C, off, len, 0) == ~crcc);
+  }
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("SYS FNV1A32 and XXH32 check values")
+{
+  static const char kFox[] = "The quick brown fox jumps over the lazy dog";
+  uint8_t ram[128] = {};
+  memcpy(ram, kCheck, 9);
+  memcpy(ram + 16, kFox, sizeof(kFox) - 1);
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), nullptr, 0};
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  CHECK(hash_range(vm, V4_SYS_FNV1A32, 0, 9, 0x811C9DC5u) == 0xBB86B11Cu);
+
+  CHECK(hash_range(vm, V4_SYS_XXH32, 0, 0, 0) == 0x02CC5D05u);
+  CHECK(hash_range(vm, V4_SYS_XXH32, 0, 9, 0) == 0x937BAD67u);
+  CHECK(hash_range(vm, V4_SYS_XXH32, 0, 9, 0x9747B28Cu) == 0x770BC670u);
+  CHECK(hash_range(vm, V4_SYS_XXH32, 16, sizeof(kFox) - 1, 0) == 0xE85EA4DEu);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("SYS hash kernels reject out-of-bounds ranges")
+{
+  uint8_t ram[32] = {};
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), nullptr, 0};
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  vm_ds_push(vm, 16);  // addr
+  vm_ds_push(vm, 17);  // len: one byte past the end
+  vm_ds_push(vm, 0);   // seed
+  CHECK(run_sys(vm, V4_SYS_CRC32) == V4_ERR(OobMemory));
+
+  // Empty range never touches memory
+  vm_ds_clear(vm);
+  CHECK(hash_range(vm, V4_SYS_CRC32, 0xFFFFFFF0u, 0, 0x1234u) == 0x1234u);
+
+  vm_destroy(vm);
+}
+
+/* ========================================================================= */
+/* Byte search and scanning kernels                                          */
+/* ========================================================================= */
+
+/* Push args, run the kernel and pop n_out results (out[0] = deepest). */
+static void call_kernel(Vm* vm, v4_u16 sys_id, const v4_i32* args, int n_args,
+                        v4_i32* out, int n_out)
+{
+  vm_ds_clear(vm);
+  for (int i = 0; i < n_args; i++)
+    vm_ds_push(vm, args[i]);
+  REQUIRE(run_sys(vm, sys_id) == 0);
+  REQUIRE(vm_ds_depth_public(vm) == n_out);
+  for (int i = n_out - 1; i >= 0; i--)
+    vm_ds_pop(vm, &out[i]);
+}
+
+TEST_CASE("SYS FIND_BYTE / FIND_ANY")
+{
+  static const char kFrame[] = "SET LED=1\r\n";
+  uint8_t ram[64] = {};
+  memcpy(ram, kFrame, sizeof(kFrame) - 1);
+  memcpy(ram + 32, "=\r", 2);
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), nullptr, 0};
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  v4_i32 out[1];
+  const v4_i32 len = (v4_i32)sizeof(kFrame) - 1;
+
+  const v4_i32 find_lf[] = {0, len, '\n'};
+  call_kernel(vm, V4_SYS_FIND_BYTE, find_lf, 3, out, 1);
+  CHECK(out[0] == 10);
+
+  const v4_i32 find_x[] = {0, len, 'X'};
+  call_kernel(vm, V4_SYS_FIND_BYTE, find_x, 3, out, 1);
+  CHECK(out[0] == -1);
+
+  // Offsets are relative to addr
+  const v4_i32 find_e[] = {4, len - 4, 'E'};
+  call_kernel(vm, V4_SYS_FIND_BYTE, find_e, 3, out, 1);
+  CHECK(out[0] == 1);
+
+  // First of '=' or '\r'
+  const v4_i32 any[] = {0, len, 32, 2};
+  call_kernel(vm, V4_SYS_FIND_ANY, any, 4, out, 1);
+  CHECK(out[0] == 7);
+
+  // Single-byte set
+  const v4_i32 any1[] = {8, len - 8, 33, 1};
+  call_kernel(vm, V4_SYS_FIND_ANY, any1, 4, out, 1);
+  CHECK(out[0] == 1);
+
+  const v4_i32 none[] = {0, 3, 32, 2};
+  call_kernel(vm, V4_SYS_FIND_ANY, none, 4, out, 1);
+  CHECK(out[0] == -1);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("SYS FIND_SUB")
+{
+  uint8_t ram[64] = {};
+  memcpy(ram, "abcabcabd", 9);
+  memcpy(ram + 32, "abd", 3);
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), nullptr, 0};
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  v4_i32 out[1];
+
+  const v4_i32 hit[] = {0, 9, 32, 3};
+  call_kernel(vm, V4_SYS_FIND_SUB, hit, 4, out, 1);
+  CHECK(out[0] == 6);
+
+  // Match must lie completely inside the range
+  const v4_i32 cut[] = {0, 8, 32, 3};
+  call_kernel(vm, V4_SYS_FIND_SUB, cut, 4, out, 1);
+  CHECK(out[0] == -1);
+
+  const v4_i32 empty[] = {0, 9, 32, 0};
+  call_kernel(vm, V4_SYS_FIND_SUB, empty, 4, out, 1);
+  CHECK(out[0] == 0);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("SYS SKIP_WS / PARSE_DEC / PARSE_HEX")
+{
+  static const char kLine[] = " \t -1234 0x1fZ ff";
+  uint8_t ram[64] = {};
+  memcpy(ram, kLine, sizeof(kLine) - 1);
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), nullptr, 0};
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  v4_i32 out[2];
+  const v4_i32 len = (v4_i32)sizeof(kLine) - 1;
+
+  const v4_i32 ws[] = {0, len};
+  call_kernel(vm, V4_SYS_SKIP_WS, ws, 2, out, 1);
+  CHECK(out[0] == 3);
+
+  const v4_i32 all_ws[] = {0, 3};
+  call_kernel(vm, V4_SYS_SKIP_WS, all_ws, 2, out, 1);
+  CHECK(out[0] == -1);
+
+  const v4_i32 dec[] = {3, len - 3};
+  call_kernel(vm, V4_SYS_PARSE_DEC, dec, 2, out, 2);
+  CHECK(out[0] == -1234);
+  CHECK(out[1] == 5);
+
+  const v4_i32 not_dec[] = {0, len};
+  call_kernel(vm, V4_SYS_PARSE_DEC, not_dec, 2, out, 2);
+  CHECK(out[0] == 0);
+  CHECK(out[1] == -1);
+
+  const v4_i32 hex[] = {9, len - 9};
+  call_kernel(vm, V4_SYS_PARSE_HEX, hex, 2, out, 2);
+  CHECK(out[0] == 0x1F);
+  CHECK(out[1] == 4);
+
+  const v4_i32 bare_hex[] = {15, 2};
+  call_kernel(vm, V4_SYS_PARSE_HEX, bare_hex, 2, out, 2);
+  CHECK(out[0] == 0xFF);
+  CHECK(out[1] == 2);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("SYS search kernels reject out-of-bounds ranges")
+{
+  uint8_t ram[32] = {};
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), nullptr, 0};
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  // Pattern range outside RAM
+  vm_ds_push(vm, 0);
+  vm_ds_push(vm, 16);
+  vm_ds_push(vm, 30);
+  vm_ds_push(vm, 4);
+  CHECK(run_sys(vm, V4_SYS_FIND_SUB) == V4_ERR(OobMemory));
+
+  vm_destroy(vm);
+}
+
+/* ========================================================================= */
+/* Number formatting and buffered output kernels                             */
+/* ========================================================================= */
+
+/* Format into ram[32..] and compare the rendered text. */
+static void check_fmt(Vm* vm, const uint8_t* ram, v4_u16 sys_id, const v4_i32* args,
+                      int n_args, const char* expect)
+{
+  v4_i32 out[1];
+  call_kernel(vm, sys_id, args, n_args, out, 1);
+  REQUIRE(out[0] == (v4_i32)strlen(expect));
+  CHECK(memcmp(ram + 32, expect, strlen(expect)) == 0);
+}
+
+TEST_CASE("SYS FMT_DEC / FMT_UDEC")
+{
+  uint8_t ram[64] = {};
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), nullptr, 0};
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  const v4_i32 zero[] = {0, 32, 16};
+  check_fmt(vm, ram, V4_SYS_FMT_DEC, zero, 3, "0");
+
+  const v4_i32 neg[] = {-1234, 32, 16};
+  check_fmt(vm, ram, V4_SYS_FMT_DEC, neg, 3, "-1234");
+
+  const v4_i32 min[] = {INT32_MIN, 32, 16};
+  check_fmt(vm, ram, V4_SYS_FMT_DEC, min, 3, "-2147483648");
+
+  const v4_i32 odd[] = {98765, 32, 16};
+  check_fmt(vm, ram, V4_SYS_FMT_DEC, odd, 3, "98765");
+
+  const v4_i32 umax[] = {-1, 32, 16};
+  check_fmt(vm, ram, V4_SYS_FMT_UDEC, umax, 3, "4294967295");
+
+  // Too small: -1 and the buffer is left untouched
+  memset(ram + 32, '#', 8);
+  v4_i32 out[1];
+  const v4_i32 tight[] = {-1234, 32, 4};
+  call_kernel(vm, V4_SYS_FMT_DEC, tight, 3, out, 1);
+  CHECK(out[0] == -1);
+  CHECK(ram[32] == '#');
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("SYS FMT_HEX / FMT_FIXED")
+{
+  uint8_t ram[64] = {};
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), nullptr, 0};
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  const v4_i32 hex[] = {0xBEEF, 0, 32, 16};
+  check_fmt(vm, ram, V4_SYS_FMT_HEX, hex, 4, "BEEF");
+
+  const v4_i32 padded[] = {0x1F, 4, 32, 16};
+  check_fmt(vm, ram, V4_SYS_FMT_HEX, padded, 4, "001F");
+
+  const v4_i32 full[] = {(v4_i32)0xDEADBEEFu, 8, 32, 16};
+  check_fmt(vm, ram, V4_SYS_FMT_HEX, full, 4, "DEADBEEF");
+
+  const v4_i32 temp[] = {2345, 2, 32, 16};
+  check_fmt(vm, ram, V4_SYS_FMT_FIXED, temp, 4, "23.45");
+
+  const v4_i32 small[] = {-5, 2, 32, 16};
+  check_fmt(vm, ram, V4_SYS_FMT_FIXED, small, 4, "-0.05");
+
+  const v4_i32 whole[] = {42, 0, 32, 16};
+  check_fmt(vm, ram, V4_SYS_FMT_FIXED, whole, 4, "42");
+
+  const v4_i32 min[] = {INT32_MIN, 4, 32, 16};
+  check_fmt(vm, ram, V4_SYS_FMT_FIXED, min, 4, "-214748.3648");
+
+  // Width / fraction digits out of range
+  vm_ds_clear(vm);
+  vm_ds_push(vm, 1);
+  vm_ds_push(vm, 9);
+  vm_ds_push(vm, 32);
+  vm_ds_push(vm, 16);
+  CHECK(run_sys(vm, V4_SYS_FMT_HEX) == V4_ERR(InvalidArg));
+
+  vm_ds_clear(vm);
+  vm_ds_push(vm, 1);
+  vm_ds_push(vm, 10);
+  vm_ds_push(vm, 32);
+  vm_ds_push(vm, 16);
+  CHECK(run_sys(vm, V4_SYS_FMT_FIXED) == V4_ERR(InvalidArg));
+
+  // Output buffer outside RAM
+  vm_ds_clear(vm);
+  vm_ds_push(vm, 7);
+  vm_ds_push(vm, 60);
+  vm_ds_push(vm, 8);
+  CHECK(run_sys(vm, V4_SYS_FMT_DEC) == V4_ERR(OobMemory));
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("SYS TYPE writes a formatted buffer in one call")
+{
+  mock_hal_reset();
+  uint8_t ram[64] = {};
+  memcpy(ram, "T=", 2);
+  VmConfig cfg{ram, (v4_u32)sizeof(ram), nullptr, 0};
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  v4_i32 out[1];
+  const v4_i32 fixed[] = {-125, 1, 2, 16};
+  call_kernel(vm, V4_SYS_FMT_FIXED, fixed, 4, out, 1);
+  REQUIRE(out[0] == 5);
+
+  const v4_i32 type[] = {0, 2 + out[0]};
+  call_kernel(vm, V4_SYS_TYPE, type, 2, out, 1);
+  CHECK(out[0] == 0);
+
+  int len = 0;
+  const char* text = mock_hal_console_get_output(&len);
+  CHECK(len == 7);
+  CHECK(memcmp(text, "T=-12.5", 7) == 0);
+
+  // Empty range is a no-op
+  const v4_i32 empty[] = {0, 0};
+  call_kernel(vm, V4_SYS_TYPE, empty, 2, out, 1);
+  CHECK(out[0] == 0);
+  mock_hal_console_get_output(&len);
+  CHECK(len == 7);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("SYS ALLOCATE / FREE / RESIZE manage a heap in RAM")
+{
+  static uint8_t ram[4096];
+  memset(ram, 0xA5, sizeof(ram));
+  VmConfig cfg{};
+  cfg.mem = ram;
+  cfg.mem_size = (v4_u32)sizeof(ram);
+  cfg.heap_base = 1024;
+  cfg.heap_size = 2048;
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  V4HeapStats st0;
+  REQUIRE(vm_heap_stats(vm, &st0) == 0);
+  CHECK(st0.size == 2048);
+  CHECK(st0.free_bytes > 1500);
+  CHECK(st0.largest_free == st0.free_bytes);
+  CHECK(st0.fragmentation == 0);
+
+  v4_i32 out[3];
+  const v4_i32 want[] = {100};
+  call_kernel(vm, V4_SYS_ALLOCATE, want, 1, out, 2);
+  REQUIRE(out[1] == 0);
+  const v4_i32 a = out[0];
+  CHECK(a >= 1024);
+  CHECK(a + 100 <= 1024 + 2048);
+  CHECK((a & 7) == 0);
+
+  call_kernel(vm, V4_SYS_ALLOCATE, want, 1, out, 2);
+  REQUIRE(out[1] == 0);
+  const v4_i32 b = out[0];
+  CHECK((b >= a + 100 || b + 100 <= a));
+
+  // Payload survives a move
+  memcpy(ram + a, "heap", 4);
+  const v4_i32 grow[] = {a, 600};
+  call_kernel(vm, V4_SYS_RESIZE, grow, 2, out, 2);
+  REQUIRE(out[1] == 0);
+  const v4_i32 a2 = out[0];
+  CHECK(memcmp(ram + a2, "heap", 4) == 0);
+
+  // Shrinking stays in place
+  const v4_i32 shrink[] = {a2, 16};
+  call_kernel(vm, V4_SYS_RESIZE, shrink, 2, out, 2);
+  CHECK(out[0] == a2);
+  CHECK(out[1] == 0);
+
+  // Double free and wild pointers are reported, not fatal
+  const v4_i32 fb[] = {b};
+  call_kernel(vm, V4_SYS_FREE, fb, 1, out, 1);
+  CHECK(out[0] == 0);
+  call_kernel(vm, V4_SYS_FREE, fb, 1, out, 1);
+  CHECK(out[0] == V4_ERR(InvalidArg));
+  const v4_i32 wild[] = {8};
+  call_kernel(vm, V4_SYS_FREE, wild, 1, out, 1);
+  CHECK(out[0] == V4_ERR(InvalidArg));
+
+  // Exhaustion leaves the block intact
+  const v4_i32 huge[] = {a2, 4000};
+  call_kernel(vm, V4_SYS_RESIZE, huge, 2, out, 2);
+  CHECK(out[0] == a2);
+  CHECK(out[1] == V4_ERR(NoMemory));
+  const v4_i32 too_big[] = {1 << 20};
+  call_kernel(vm, V4_SYS_ALLOCATE, too_big, 1, out, 2);
+  CHECK(out[1] == V4_ERR(NoMemory));
+
+  // Freeing everything coalesces back to a single block
+  const v4_i32 fa[] = {a2};
+  call_kernel(vm, V4_SYS_FREE, fa, 1, out, 1);
+  CHECK(out[0] == 0);
+  call_kernel(vm, V4_SYS_HEAP_STATS, nullptr, 0, out, 3);
+  CHECK((v4_u32)out[0] == st0.free_bytes);
+  CHECK((v4_u32)out[1] == st0.largest_free);
+  CHECK(out[2] == 0);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("SYS heap reports fragmentation and follows rollback")
+{
+  static uint8_t ram[4096];
+  VmConfig cfg{};
+  cfg.mem = ram;
+  cfg.mem_size = (v4_u32)sizeof(ram);
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  // No heap configured
+  v4_i32 out[3];
+  const v4_i32 want[] = {64};
+  call_kernel(vm, V4_SYS_ALLOCATE, want, 1, out, 2);
+  CHECK(out[1] == V4_ERR(InvalidArg));
+  CHECK(vm_heap_init(vm, 4000, 512) == V4_ERR(InvalidArg));
+  REQUIRE(vm_heap_init(vm, 0, 4096) == 0);
+
+  // Free every other block of a full row
+  v4_i32 blocks[16];
+  for (int i = 0; i < 16; i++)
+  {
+    call_kernel(vm, V4_SYS_ALLOCATE, want, 1, out, 2);
+    REQUIRE(out[1] == 0);
+    blocks[i] = out[0];
+  }
+  V4HeapStats before;
+  REQUIRE(vm_heap_stats(vm, &before) == 0);
+
+  REQUIRE(vm_checkpoint(vm) == 0);
+  for (int i = 0; i < 16; i += 2)
+  {
+    call_kernel(vm, V4_SYS_FREE, &blocks[i], 1, out, 1);
+    REQUIRE(out[0] == 0);
+  }
+  V4HeapStats st;
+  REQUIRE(vm_heap_stats(vm, &st) == 0);
+  CHECK(st.free_bytes == before.free_bytes + 8 * 64);
+  CHECK(st.largest_free == before.largest_free);
+  CHECK(st.fragmentation > 0);
+
+  // The allocator state is plain RAM, so rollback restores it
+  REQUIRE(vm_rollback(vm) == 0);
+  REQUIRE(vm_heap_stats(vm, &st) == 0);
+  CHECK(st.free_bytes == before.free_bytes);
+  call_kernel(vm, V4_SYS_FREE, &blocks[1], 1, out, 1);
+  CHECK(out[0] == 0);
+
+  vm_destroy(vm);
+}
+
+/* ========================================================================= */
+/* SPSC ring buffer kernels                                                  */
+/* ========================================================================= */
+
+TEST_CASE("SYS RING_* move bytes, cells and blocks through a ring")
+{
+  static uint8_t ram[1024];
+  memset(ram, 0, sizeof(ram));
+  VmConfig cfg{};
+  cfg.mem = ram;
+  cfg.mem_size = (v4_u32)sizeof(ram);
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  const v4_i32 ring = 0x100;
+  v4_i32 out[3];
+  const v4_i32 init[] = {ring, 16};
+  call_kernel(vm, V4_SYS_RING_INIT, init, 2, out, 0);
+
+  // Bytes and cells are FIFO; a cell is all-or-nothing
+  const v4_i32 put_a[] = {'A', ring};
+  call_kernel(vm, V4_SYS_RING_PUT, put_a, 2, out, 1);
+  CHECK(out[0] == V4_TRUE);
+  const v4_i32 put_x[] = {(v4_i32)0xDEADBEEFu, ring};
+  call_kernel(vm, V4_SYS_RING_PUT_CELL, put_x, 2, out, 1);
+  CHECK(out[0] == V4_TRUE);
+  const v4_i32 r[] = {ring};
+  call_kernel(vm, V4_SYS_RING_COUNT, r, 1, out, 2);
+  CHECK(out[0] == 5);
+  CHECK(out[1] == 11);
+  call_kernel(vm, V4_SYS_RING_GET, r, 1, out, 2);
+  CHECK(out[0] == 'A');
+  CHECK(out[1] == V4_TRUE);
+  call_kernel(vm, V4_SYS_RING_GET_CELL, r, 1, out, 2);
+  CHECK((v4_u32)out[0] == 0xDEADBEEFu);
+  CHECK(out[1] == V4_TRUE);
+  call_kernel(vm, V4_SYS_RING_GET, r, 1, out, 2);
+  CHECK(out[0] == 0);
+  CHECK(out[1] == V4_FALSE);
+
+  // Block writes stop at the free space and wrap around the end
+  memcpy(ram + 0x200, "0123456789abcdefXYZ", 19);
+  const v4_i32 wr[] = {0x200, 19, ring};
+  call_kernel(vm, V4_SYS_RING_WRITE, wr, 3, out, 1);
+  CHECK(out[0] == 16);
+  call_kernel(vm, V4_SYS_RING_PUT, put_a, 2, out, 1);
+  CHECK(out[0] == V4_FALSE);
+  call_kernel(vm, V4_SYS_RING_PUT_CELL, put_x, 2, out, 1);
+  CHECK(out[0] == V4_FALSE);
+
+  const v4_i32 rd[] = {0x300, 10, ring};
+  call_kernel(vm, V4_SYS_RING_READ, rd, 3, out, 1);
+  CHECK(out[0] == 10);
+  CHECK(memcmp(ram + 0x300, "0123456789", 10) == 0);
+  call_kernel(vm, V4_SYS_RING_PUT_CELL, put_x, 2, out, 1);
+  CHECK(out[0] == V4_TRUE);
+  const v4_i32 rd_all[] = {0x300, 64, ring};
+  call_kernel(vm, V4_SYS_RING_READ, rd_all, 3, out, 1);
+  CHECK(out[0] == 10);
+  CHECK(memcmp(ram + 0x300, "abcdef\xEF\xBE\xAD\xDE", 10) == 0);
+
+  // Host producer (e.g. an ISR) feeding a bytecode consumer
+  CHECK(vm_ring_write(vm, (v4_u32)ring, "hello", 5) == 5);
+  char host[8] = {};
+  CHECK(vm_ring_read(vm, (v4_u32)ring, host, sizeof(host)) == 5);
+  CHECK(memcmp(host, "hello", 5) == 0);
+  CHECK(vm_ring_read(vm, (v4_u32)ring, host, sizeof(host)) == 0);
+
+  vm_destroy(vm);
+}
+
+TEST_CASE("SYS RING_* reject bad rings")
+{
+  static uint8_t ram[256];
+  memset(ram, 0, sizeof(ram));
+  VmConfig cfg{};
+  cfg.mem = ram;
+  cfg.mem_size = (v4_u32)sizeof(ram);
+  Vm* vm = vm_create(&cfg);
+  REQUIRE(vm);
+
+  CHECK(vm_ring_init(vm, 0, 24) == V4_ERR(InvalidArg));
+  CHECK(vm_ring_init(vm, 2, 16) == V4_ERR(Unaligned));
+  CHECK(vm_ring_init(vm, 128, 128) == V4_ERR(OobMemory));
+  REQUIRE(vm_ring_init(vm, 0, 64) == 0);
+
+  // An unformatted header and a corrupted one abort the kernel
+  vm_ds_clear(vm);
+  vm_ds_push(vm, 128);
+  CHECK(run_sys(vm, V4_SYS_RING_GET) == V4_ERR(InvalidArg));
+  ram[0] = 200;  // head - tail > cap
+  vm_ds_clear(vm);
+  vm_ds_push(vm, 0);
+  CHECK(run_sys(vm, V4_SYS_RING_GET) == V4_ERR(InvalidArg));
+  CHECK(vm_ring_write(vm, 0, "x", 1) == V4_ERR(InvalidArg));
+
+  // Block buffers are range-checked like any other kernel argument
+  REQUIRE(vm_ring_init(vm, 0, 64) == 0);
+  vm_ds_clear(vm);
+  vm_ds_push(vm, 200);
+  vm_ds_push(vm, 100);
+  vm_ds_push(vm, 0);
+  CHECK(run_sys(vm, V4_SYS_RING_WRITE) == V4_ERR(OobMemory));
+
+  vm_destroy(vm);
+}
@@ -376,6 +376,79 @@ TEST_CASE("conditional branch (JNZ)")
   CHECK(vm.DS[0] == 3);
 }
 
+/* Build: LIT idx; JMPTBL {3 cases}; 4 arms of `LIT_U8 n; RET`. */
+static int build_jmptbl(v4_u8 *code, v4_i32 idx)
+{
+  int k = 0;
+  emit8(code, &k, (v4_u8)v4::Op::LIT);
+  emit32(code, &k, idx);
+  emit8(code, &k, (v4_u8)v4::Op::JMPTBL);
+  emit16(code, &k, 3);   // count
+  emit16(code, &k, 9);   // default -> arm 3
+  emit16(code, &k, 0);   // case 0 -> arm 0
+  emit16(code, &k, 3);   // case 1 -> arm 1
+  emit16(code, &k, 6);   // case 2 -> arm 2
+  for (int arm = 0; arm < 4; arm++)
+  {
+    emit8(code, &k, (v4_u8)v4::Op::LIT_U8);
+    emit8(code, &k, (v4_u8)(10 + arm));
+    emit8(code, &k, (v4_u8)v4::Op::RET);
+  }
+  return k;
+}
+
+TEST_CASE("jump table (JMPTBL)")
+{
+  v4_u8 code[64];
+  const v4_i32 idx[] = {0, 1, 2, 3, 1000, -1};
+  const v4_i32 expect[] = {10, 11, 12, 13, 13, 13};
+  for (int i = 0; i < 6; i++)
+  {
+    CAPTURE(idx[i]);
+    Vm vm{};
+    vm_reset(&vm);
+    int len = build_jmptbl(code, idx[i]);
+    int rc = vm_exec_raw(&vm, code, len);
+    CHECK(rc == 0);
+    CHECK(vm.sp == vm.DS + 1);
+    CHECK(vm.DS[0] == expect[i]);
+  }
+}
+
+TEST_CASE("jump table (JMPTBL) backward target and errors")
+{
+  Vm vm{};
+  vm_reset(&vm);
+
+  // Loop: n JMPTBL{0 -> exit} default -> back to DEC
+  v4_u8 code[32];
+  int k = 0;
+  emit8(code, &k, (v4_u8)v4::Op::LIT);
+  emit32(code, &k, 4);
+  int loop = k;
+  emit8(code, &k, (v4_u8)v4::Op::DEC);
+  emit8(code, &k, (v4_u8)v4::Op::DUP);
+  emit8(code, &k, (v4_u8)v4::Op::JMPTBL);
+  emit16(code, &k, 1);
+  emit16(code, &k, (int16_t)(loop - (k + 4)));  // default: loop again
+  emit16(code, &k, 0);                           // 0: fall out
+  emit8(code, &k, (v4_u8)v4::Op::RET);
+  CHECK(vm_exec_raw(&vm, code, k) == 0);
+  CHECK(vm.sp == vm.DS + 1);
+  CHECK(vm.DS[0] == 0);
+
+  // Table runs past the end of the code
+  vm_reset(&vm);
+  v4_u8 cut[] = {(v4_u8)v4::Op::LIT0, (v4_u8)v4::Op::JMPTBL, 2, 0, 0, 0, 0, 0};
+  CHECK(vm_exec_raw(&vm, cut, (int)sizeof(cut)) == static_cast<int>(Err::TruncatedJump));
+
+  // Target outside the code
+  vm_reset(&vm);
+  v4_u8 far[] = {(v4_u8)v4::Op::LIT0, (v4_u8)v4::Op::JMPTBL, 1, 0, 0, 0, 0x40, 0,
+                 (v4_u8)v4::Op::RET};
+  CHECK(vm_exec_raw(&vm, far, (int)sizeof(far)) == static_cast<int>(Err::JumpOutOfRange));
+}
+
 /* ------------------------------------------------------------------------- */
 /* Error paths                                                               */
 /* ------------------------------------------------------------------------- */
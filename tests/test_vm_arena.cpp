@@ -23,7 +23,7 @@ TEST_CASE("VM with arena - word registration")
 
   // Create VM with arena
   uint8_t mem[256];
-  VmConfig cfg;
+  VmConfig cfg{};
   cfg.mem = mem;
   cfg.mem_size = sizeof(mem);
   cfg.mmio = nullptr;
@@ -45,8 +45,8 @@ TEST_CASE("VM with arena - word registration")
   // Check word was registered
   Word* word = vm_get_word(vm, idx);
   REQUIRE(word != nullptr);
-  REQUIRE(word->name != nullptr);
-  CHECK(strcmp(word->name, "TEST_WORD") == 0);
+  REQUIRE(vm_word_get_name(word) != nullptr);
+  CHECK(strcmp(vm_word_get_name(word), "TEST_WORD") == 0);
 
   // Check name is in arena
   size_t arena_used = v4_arena_used(&arena);
@@ -63,7 +63,7 @@ TEST_CASE("VM with arena - multiple words")
   v4_arena_init(&arena, arena_buffer, sizeof(arena_buffer));
 
   uint8_t mem[256];
-  VmConfig cfg;
+  VmConfig cfg{};
   cfg.mem = mem;
   cfg.mem_size = sizeof(mem);
   cfg.mmio = nullptr;
@@ -85,9 +85,9 @@ TEST_CASE("VM with arena - multiple words")
   CHECK(vm->word_count == 3);
 
   // Check all names are present
-  CHECK(strcmp(vm->words[0].name, "WORD1") == 0);
-  CHECK(strcmp(vm->words[1].name, "WORD2") == 0);
-  CHECK(strcmp(vm->words[2].name, "WORD3") == 0);
+  CHECK(strcmp(vm_word_get_name(vm_get_word(vm, 0)), "WORD1") == 0);
+  CHECK(strcmp(vm_word_get_name(vm_get_word(vm, 1)), "WORD2") == 0);
+  CHECK(strcmp(vm_word_get_name(vm_get_word(vm, 2)), "WORD3") == 0);
 
   // Check arena usage
   size_t expected_min = strlen("WORD1") + 1 + strlen("WORD2") + 1 + strlen("WORD3") + 1;
@@ -103,7 +103,7 @@ TEST_CASE("VM with arena - anonymous words")
   v4_arena_init(&arena, arena_buffer, sizeof(arena_buffer));
 
   uint8_t mem[256];
-  VmConfig cfg;
+  VmConfig cfg{};
   cfg.mem = mem;
   cfg.mem_size = sizeof(mem);
   cfg.mmio = nullptr;
@@ -123,7 +123,7 @@ TEST_CASE("VM with arena - anonymous words")
   size_t arena_after = v4_arena_used(&arena);
 
   CHECK(idx == 0);
-  CHECK(vm->words[0].name == nullptr);
+  CHECK(vm_word_get_name(vm_get_word(vm, 0)) == nullptr);
 
   // Arena should not grow for anonymous word
   CHECK(arena_before == arena_after);
@@ -138,7 +138,7 @@ TEST_CASE("VM with arena - reset dictionary")
   v4_arena_init(&arena, arena_buffer, sizeof(arena_buffer));
 
   uint8_t mem[256];
-  VmConfig cfg;
+  VmConfig cfg{};
   cfg.mem = mem;
   cfg.mem_size = sizeof(mem);
   cfg.mmio = nullptr;
@@ -176,7 +176,7 @@ TEST_CASE("VM with arena - arena reset and reuse")
   v4_arena_init(&arena, arena_buffer, sizeof(arena_buffer));
 
   uint8_t mem[256];
-  VmConfig cfg;
+  VmConfig cfg{};
   cfg.mem = mem;
   cfg.mem_size = sizeof(mem);
   cfg.mmio = nullptr;
@@ -209,8 +209,8 @@ TEST_CASE("VM with arena - arena reset and reuse")
   vm_register_word(vm, "NEW_WORD2", code, k);
 
   CHECK(vm->word_count == 2);
-  CHECK(strcmp(vm->words[0].name, "NEW_WORD1") == 0);
-  CHECK(strcmp(vm->words[1].name, "NEW_WORD2") == 0);
+  CHECK(strcmp(vm_word_get_name(vm_get_word(vm, 0)), "NEW_WORD1") == 0);
+  CHECK(strcmp(vm_word_get_name(vm_get_word(vm, 1)), "NEW_WORD2") == 0);
 
   vm_destroy(vm);
 }
@@ -219,7 +219,7 @@ TEST_CASE("VM without arena - uses malloc")
 {
   // Create VM without arena (NULL)
   uint8_t mem[256];
-  VmConfig cfg;
+  VmConfig cfg{};
   cfg.mem = mem;
   cfg.mem_size = sizeof(mem);
   cfg.mmio = nullptr;
@@ -241,8 +241,8 @@ TEST_CASE("VM without arena - uses malloc")
   // Check word was registered
   Word* word = vm_get_word(vm, idx);
   REQUIRE(word != nullptr);
-  REQUIRE(word->name != nullptr);
-  CHECK(strcmp(word->name, "MALLOC_WORD") == 0);
+  REQUIRE(vm_word_get_name(word) != nullptr);
+  CHECK(strcmp(vm_word_get_name(word), "MALLOC_WORD") == 0);
 
   // Reset dictionary (should free malloc'd memory)
   vm_reset_dictionary(vm);
@@ -260,7 +260,7 @@ TEST_CASE("VM with arena - out of memory")
   v4_arena_init(&arena, arena_buffer, sizeof(arena_buffer));
 
   uint8_t mem[256];
-  VmConfig cfg;
+  VmConfig cfg{};
   cfg.mem = mem;
   cfg.mem_size = sizeof(mem);
   cfg.mmio = nullptr;
@@ -9,7 +9,7 @@ int main(void)
   uint8_t ram[32] = {0};
 
   // Configure a VM with 32 bytes of RAM and no MMIO windows.
-  VmConfig cfg;
+  VmConfig cfg = {0};
   cfg.mem = ram;
   cfg.mem_size = (v4_u32)sizeof(ram);
   cfg.mmio = NULL;
@@ -4,7 +4,7 @@
  *
  * Word shadowing is a fundamental Forth feature where newer word definitions
  * with the same name hide (shadow) older definitions. This file tests that
- * the VM correctly implements this behavior through backward search in the
+ * the VM correctly implements this behavior through the name index of the
  * word dictionary.
  *
  * @copyright Copyright 2025 Akihito Kirisaki
@@ -13,6 +13,7 @@
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 
 #include "doctest.h"
@@ -324,3 +325,72 @@ TEST_CASE("Word shadowing: Interleaved definitions")
   REQUIRE(idx_foo2 != idx_foo3);
   REQUIRE(idx_bar1 != idx_bar2);
 }
+
+/* ========================================================================= */
+/* Name index                                                                */
+/* ========================================================================= */
+
+TEST_CASE("vm_find_word: Index survives growth, reset and fork")
+{
+  VmFixture vm;
+  uint8_t code[6];
+  make_lit_ret_bytecode(code, 1);
+
+  // Enough names to grow the index several times; every 4th is a redefinition
+  char name[16];
+  int last[64];
+  for (int i = 0; i < 250; i++)
+  {
+    snprintf(name, sizeof(name), "W%d", i % 4 == 3 ? i % 64 : i);
+    const int idx = vm_register_word(vm.ptr(), name, code, 6);
+    REQUIRE(idx == i);
+    if (i % 4 == 3 || i < 64)
+      last[i % 4 == 3 ? i % 64 : i] = idx;
+  }
+  for (int i = 0; i < 250; i++)
+  {
+    if (i % 4 == 3)
+      continue;
+    snprintf(name, sizeof(name), "W%d", i);
+    CHECK(vm_find_word(vm.ptr(), name) == (i < 64 ? last[i] : i));
+  }
+  CHECK(vm_find_word(vm.ptr(), "W250") == -1);
+
+  // A reset empties the index with the dictionary
+  vm_reset_dictionary(vm.ptr());
+  CHECK(vm_find_word(vm.ptr(), "W0") == -1);
+  CHECK(vm_register_word(vm.ptr(), "W0", code, 6) == 0);
+  CHECK(vm_find_word(vm.ptr(), "W0") == 0);
+}
+
+TEST_CASE("vm_find_word: Arena-backed index and forked dictionaries")
+{
+  static uint8_t ram[256];
+  static uint8_t store[8192];
+  V4Arena arena;
+  v4_arena_init(&arena, store, sizeof(store));
+  VmConfig cfg{};
+  cfg.mem = ram;
+  cfg.mem_size = sizeof(ram);
+  cfg.arena = &arena;
+  Vm* tmpl = vm_create(&cfg);
+  REQUIRE(tmpl);
+
+  uint8_t code[6];
+  make_lit_ret_bytecode(code, 7);
+  const size_t before = v4_arena_used(&arena);
+  REQUIRE(vm_register_word(tmpl, "DUP2", code, 6) == 0);
+  REQUIRE(vm_register_word(tmpl, "SWAP2", code, 6) == 1);
+  CHECK(v4_arena_used(&arena) >= before + 64 * sizeof(int32_t));
+
+  // The fork builds its own index over the inherited words
+  Vm* child = vm_fork(tmpl);
+  REQUIRE(child);
+  CHECK(vm_find_word(child, "SWAP2") == 1);
+  REQUIRE(vm_register_word(child, "DUP2", code, 6) == 2);
+  CHECK(vm_find_word(child, "DUP2") == 2);
+  CHECK(vm_find_word(tmpl, "DUP2") == 0);
+
+  vm_destroy(child);
+  vm_destroy(tmpl);
+}